@@ -0,0 +1,228 @@
+// Micro-benchmarks for the DSP engine: ns per sample and samples per second
+// for every distortion type over a grid of drives, block sizes, channel
+// counts and filter settings. Results go out as JSON so runs can be compared
+// across commits and machines.
+//
+//   ObliteratorBenchmarks [--output=results.json] [--label=text] [--quick]
+
+#include <juce_core/juce_core.h>
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <vector>
+#include "DSP/DistortionEngine.h"
+
+#ifndef OBLITERATOR_GIT_COMMIT
+ #define OBLITERATOR_GIT_COMMIT "unknown"
+#endif
+
+namespace
+{
+constexpr double sampleRate = 48000.0;
+
+struct BenchmarkCase
+{
+    DistortionType algorithm;
+    float drive;
+    int blockSize;
+    int numChannels;
+    bool subOctave;
+    bool tone;
+};
+
+struct Timing
+{
+    double medianNsPerSample = 0.0;
+    double minNsPerSample = 0.0;
+};
+
+const char* getAlgorithmName(DistortionType algorithm)
+{
+    switch (algorithm)
+    {
+        case DistortionType::Tanh:     return "Tanh";
+        case DistortionType::Foldback: return "Foldback";
+        case DistortionType::Tube:     return "Tube";
+    }
+
+    return "Unknown";
+}
+
+// A few inharmonic partials at about -6 dBFS, different per channel, so the
+// waveshapers and the sub-octave see a realistic spread of levels and zero
+// crossings
+std::vector<std::vector<float>> createInput(int numChannels, int numSamples)
+{
+    std::vector<std::vector<float>> input(static_cast<size_t>(numChannels),
+                                          std::vector<float>(static_cast<size_t>(numSamples)));
+
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+        auto& samples = input[static_cast<size_t>(channel)];
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const double t = i / sampleRate;
+            samples[static_cast<size_t>(i)] = static_cast<float>(
+                    0.3 * std::sin(juce::MathConstants<double>::twoPi * (110.0 + 3.0 * channel) * t)
+                  + 0.15 * std::sin(juce::MathConstants<double>::twoPi * 587.3 * t)
+                  + 0.05 * std::sin(juce::MathConstants<double>::twoPi * 3141.0 * t));
+        }
+    }
+
+    return input;
+}
+
+Timing runCase(const BenchmarkCase& benchmark, const std::vector<std::vector<float>>& input,
+               int samplesPerRun, int numRuns)
+{
+    DistortionEngine<float> engine;
+    engine.prepare(sampleRate, benchmark.blockSize, benchmark.numChannels);
+
+    // The first call after prepare() jumps straight to the values, so no
+    // parameter ramp is measured
+    DistortionParameters parameters;
+    parameters.algorithm = benchmark.algorithm;
+    parameters.drive = benchmark.drive;
+    parameters.subOctave = benchmark.subOctave ? 0.5f : 0.0f;
+    parameters.tone = benchmark.tone ? 0.25f : 0.5f;
+    engine.setParameters(parameters);
+
+    std::vector<std::vector<float>> work(input.begin(), input.begin() + benchmark.numChannels);
+    std::vector<float*> channels(static_cast<size_t>(benchmark.numChannels));
+    std::vector<double> nsPerSample;
+
+    juce::ScopedNoDenormals noDenormals;
+
+    // One untimed run to warm caches, branch predictors and the filter state
+    for (int run = 0; run <= numRuns; ++run)
+    {
+        for (int channel = 0; channel < benchmark.numChannels; ++channel)
+            std::copy(input[static_cast<size_t>(channel)].begin(), input[static_cast<size_t>(channel)].end(),
+                      work[static_cast<size_t>(channel)].begin());
+
+        const auto start = std::chrono::steady_clock::now();
+
+        for (int offset = 0; offset < samplesPerRun; offset += benchmark.blockSize)
+        {
+            const int numSamples = std::min(benchmark.blockSize, samplesPerRun - offset);
+            for (int channel = 0; channel < benchmark.numChannels; ++channel)
+                channels[static_cast<size_t>(channel)] = work[static_cast<size_t>(channel)].data() + offset;
+
+            engine.process(channels.data(), benchmark.numChannels, numSamples);
+        }
+
+        const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+        if (run > 0)
+            nsPerSample.push_back(elapsed.count() / (double (samplesPerRun) * benchmark.numChannels));
+    }
+
+    std::sort(nsPerSample.begin(), nsPerSample.end());
+    return { nsPerSample[nsPerSample.size() / 2], nsPerSample.front() };
+}
+
+juce::var createMachineInfo(const juce::String& label)
+{
+    auto* info = new juce::DynamicObject();
+    info->setProperty("label", label);
+    info->setProperty("commit", OBLITERATOR_GIT_COMMIT);
+    info->setProperty("time", juce::Time::getCurrentTime().toISO8601(true));
+    info->setProperty("cpu", juce::SystemStats::getCpuModel());
+    info->setProperty("cpuVendor", juce::SystemStats::getCpuVendor());
+    info->setProperty("logicalCpus", juce::SystemStats::getNumCpus());
+    info->setProperty("cpuSpeedMHz", juce::SystemStats::getCpuSpeedInMegahertz());
+    info->setProperty("os", juce::SystemStats::getOperatingSystemName());
+   #if defined(_MSC_VER) && ! defined(__clang__)
+    info->setProperty("compiler", "MSVC " + juce::String(_MSC_VER));
+   #else
+    info->setProperty("compiler", __VERSION__);
+   #endif
+   #if defined(NDEBUG)
+    info->setProperty("build", "release");
+   #else
+    info->setProperty("build", "debug");
+   #endif
+    return info;
+}
+} // namespace
+
+//==============================================================================
+int main(int argc, char* argv[])
+{
+    juce::ArgumentList arguments(argc, argv);
+    const bool quick = arguments.containsOption("--quick");
+    const auto label = arguments.getValueForOption("--label");
+    const auto outputPath = arguments.getValueForOption("--output");
+
+    const int samplesPerRun = quick ? 1 << 14 : 1 << 16;
+    const int numRuns = quick ? 3 : 7;
+
+    // Drive 1.0 takes the clean path, which skips the waveshaper and the DC
+    // blocker. Above it every waveshaper, foldback included, is closed form
+    // with no drive-dependent work, so the higher drives should cost the
+    // same and any trend across them is a regression.
+    const DistortionType algorithms[] { DistortionType::Tanh, DistortionType::Foldback, DistortionType::Tube };
+    const float drives[] { 1.0f, 10.0f, 100.0f, 1000.0f };
+    const int blockSizes[] { 1, 4, 16, 64, 256, 1024, 4096 };
+    const int channelCounts[] { 1, 2 };
+
+    const auto input = createInput(2, samplesPerRun);
+    juce::Array<juce::var> results;
+
+    for (auto algorithm : algorithms)
+        for (auto drive : drives)
+            for (auto blockSize : blockSizes)
+                for (auto numChannels : channelCounts)
+                    for (bool subOctave : { false, true })
+                        for (bool tone : { false, true })
+                        {
+                            const BenchmarkCase benchmark { algorithm, drive, blockSize, numChannels, subOctave, tone };
+                            const auto timing = runCase(benchmark, input, samplesPerRun, numRuns);
+
+                            auto* result = new juce::DynamicObject();
+                            result->setProperty("algorithm", getAlgorithmName(algorithm));
+                            result->setProperty("drive", drive);
+                            result->setProperty("blockSize", blockSize);
+                            result->setProperty("channels", numChannels);
+                            result->setProperty("subOctave", subOctave);
+                            result->setProperty("tone", tone);
+                            result->setProperty("nsPerSample", timing.medianNsPerSample);
+                            result->setProperty("minNsPerSample", timing.minNsPerSample);
+                            result->setProperty("samplesPerSecond", 1.0e9 / timing.medianNsPerSample);
+                            results.add(result);
+
+                            std::cerr << getAlgorithmName(algorithm) << " drive " << drive
+                                      << " block " << blockSize << " ch " << numChannels
+                                      << (subOctave ? " sub" : "") << (tone ? " tone" : "")
+                                      << ": " << timing.medianNsPerSample << " ns/sample\n";
+                        }
+
+    auto* root = new juce::DynamicObject();
+    root->setProperty("benchmark", "ObliteratorBenchmarks");
+    root->setProperty("formatVersion", 1);
+    root->setProperty("machine", createMachineInfo(label));
+    root->setProperty("sampleRate", sampleRate);
+    root->setProperty("sampleType", "float");
+    root->setProperty("precision", "Accurate");
+    root->setProperty("samplesPerRun", samplesPerRun);
+    root->setProperty("runs", numRuns);
+    root->setProperty("results", results);
+
+    const auto json = juce::JSON::toString(juce::var(root));
+
+    if (outputPath.isEmpty())
+    {
+        std::cout << json << std::endl;
+        return 0;
+    }
+
+    const auto file = juce::File::getCurrentWorkingDirectory().getChildFile(outputPath);
+    if (! file.replaceWithText(json))
+    {
+        std::cerr << "Could not write " << file.getFullPathName() << "\n";
+        return 1;
+    }
+
+    return 0;
+}
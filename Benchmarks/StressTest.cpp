@@ -0,0 +1,822 @@
+// Real-time safety and worst-case latency stress test for the whole plugin
+// processor, without a host or a display. An audio thread feeds the
+// processor blocks of random size (single samples, odd sizes and up to four
+// times the prepared size) while every automatable parameter jumps on every
+// block, the algorithm, precision and antialiasing switch mid-stream and the
+// host bypass comes and goes. Meanwhile the message thread behaves like an
+// editor being opened and closed: it attaches and detaches the display
+// readers, polls the meters and the load table, changes oversampling and
+// round-trips the plugin state. Each precision runs as its own phase.
+//
+// The run fails if, inside processBlock, the audio thread
+//   - allocates or frees memory (malloc and friends, glibc only),
+//   - blocks on a mutex, rwlock or semaphore (glibc only),
+//   - computes with denormals (x86-64 Linux, see below),
+// or if the output contains NaN, infinity or subnormal samples.
+// Block times are reported as p50/p99/p99.9/max and against each block's
+// real-time deadline. Those depend on the machine, so they never fail a run.
+//
+//   ObliteratorStressTest [--blocks=N] [--seed=N] [--sample-rate=Hz]
+//                         [--block-size=N] [--channels=N]
+
+#include <JuceHeader.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <thread>
+#include <vector>
+#include "PluginProcessor.h"
+
+#if defined(__GLIBC__)
+ #define OBLITERATOR_HOOK_LIBC 1
+ #include <dlfcn.h>
+ #include <execinfo.h>
+ #include <pthread.h>
+ #include <semaphore.h>
+ #include <unistd.h>
+#else
+ #define OBLITERATOR_HOOK_LIBC 0
+ #include <new>
+#endif
+
+#if OBLITERATOR_HOOK_LIBC && defined(__x86_64__)
+ #define OBLITERATOR_TRAP_DENORMALS 1
+ #include <csignal>
+ #include <ucontext.h>
+ #include <xmmintrin.h>
+#else
+ #define OBLITERATOR_TRAP_DENORMALS 0
+#endif
+
+//==============================================================================
+// Set on the audio thread for exactly the duration of processBlock, so the
+// hooks below only report what the plugin itself does there
+namespace
+{
+thread_local bool insideProcessBlock = false;
+
+struct Violations
+{
+    std::atomic<uint64_t> allocations { 0 };
+    std::atomic<uint64_t> locks { 0 };
+    std::atomic<uint64_t> denormals { 0 };
+    std::atomic<uint64_t> flushedUnderflows { 0 };  // Harmless, see onFloatingPointException()
+};
+
+Violations violations;
+
+// Where the first allocation or lock happened
+std::atomic<bool> firstViolationCaptured { false };
+const char* firstViolationKind = nullptr;
+void* firstViolationTrace[48];
+int firstViolationDepth = 0;
+
+void noteViolation(std::atomic<uint64_t>& counter, const char* kind)
+{
+    counter.fetch_add(1, std::memory_order_relaxed);
+
+    if (firstViolationCaptured.exchange(true))
+        return;
+
+    firstViolationKind = kind;
+   #if OBLITERATOR_HOOK_LIBC
+    // backtrace() was warmed up in main(), so it does not allocate here
+    insideProcessBlock = false;
+    firstViolationDepth = backtrace(firstViolationTrace, static_cast<int>(std::size(firstViolationTrace)));
+    insideProcessBlock = true;
+   #endif
+}
+
+inline void noteAllocation()
+{
+    if (insideProcessBlock)
+        noteViolation(violations.allocations, "allocation");
+}
+
+[[maybe_unused]] inline void noteLock()
+{
+    if (insideProcessBlock)
+        noteViolation(violations.locks, "lock");
+}
+} // namespace
+
+//==============================================================================
+// Allocation and lock hooks. On glibc the executable's definitions take the
+// place of the C library's for every caller in the process, JUCE and the
+// C++ runtime included, and forward to the real functions. Elsewhere only
+// operator new and delete can be replaced, and locks go unchecked.
+#if OBLITERATOR_HOOK_LIBC
+extern "C"
+{
+void* __libc_malloc(size_t);
+void* __libc_calloc(size_t, size_t);
+void* __libc_realloc(void*, size_t);
+void* __libc_memalign(size_t, size_t);
+void __libc_free(void*);
+
+void* malloc(size_t size) noexcept
+{
+    noteAllocation();
+    return __libc_malloc(size);
+}
+
+void* calloc(size_t count, size_t size) noexcept
+{
+    noteAllocation();
+    return __libc_calloc(count, size);
+}
+
+void* realloc(void* pointer, size_t size) noexcept
+{
+    noteAllocation();
+    return __libc_realloc(pointer, size);
+}
+
+void* memalign(size_t alignment, size_t size) noexcept
+{
+    noteAllocation();
+    return __libc_memalign(alignment, size);
+}
+
+void* aligned_alloc(size_t alignment, size_t size) noexcept
+{
+    noteAllocation();
+    return __libc_memalign(alignment, size);
+}
+
+int posix_memalign(void** result, size_t alignment, size_t size) noexcept
+{
+    noteAllocation();
+
+    if (alignment % sizeof(void*) != 0 || (alignment & (alignment - 1)) != 0)
+        return EINVAL;
+
+    auto* pointer = __libc_memalign(alignment, size);
+    if (pointer == nullptr)
+        return ENOMEM;
+
+    *result = pointer;
+    return 0;
+}
+
+void free(void* pointer) noexcept
+{
+    if (pointer != nullptr)
+        noteAllocation();
+
+    __libc_free(pointer);
+}
+}
+
+// The real lock functions, looked up on first use. A condition variable
+// wait needs its mutex locked first, so the mutex hook covers those too.
+template <typename Function>
+Function findNext(std::atomic<Function>& cache, const char* name)
+{
+    auto function = cache.load(std::memory_order_acquire);
+    if (function == nullptr)
+    {
+        function = reinterpret_cast<Function>(dlsym(RTLD_NEXT, name));
+        cache.store(function, std::memory_order_release);
+    }
+
+    return function;
+}
+
+extern "C"
+{
+int pthread_mutex_lock(pthread_mutex_t* mutex) noexcept
+{
+    static std::atomic<int (*)(pthread_mutex_t*)> next { nullptr };
+    noteLock();
+    return findNext(next, "pthread_mutex_lock")(mutex);
+}
+
+int pthread_mutex_timedlock(pthread_mutex_t* mutex, const timespec* timeout) noexcept
+{
+    static std::atomic<int (*)(pthread_mutex_t*, const timespec*)> next { nullptr };
+    noteLock();
+    return findNext(next, "pthread_mutex_timedlock")(mutex, timeout);
+}
+
+int pthread_rwlock_rdlock(pthread_rwlock_t* lock) noexcept
+{
+    static std::atomic<int (*)(pthread_rwlock_t*)> next { nullptr };
+    noteLock();
+    return findNext(next, "pthread_rwlock_rdlock")(lock);
+}
+
+int pthread_rwlock_wrlock(pthread_rwlock_t* lock) noexcept
+{
+    static std::atomic<int (*)(pthread_rwlock_t*)> next { nullptr };
+    noteLock();
+    return findNext(next, "pthread_rwlock_wrlock")(lock);
+}
+
+int sem_wait(sem_t* semaphore)
+{
+    static std::atomic<int (*)(sem_t*)> next { nullptr };
+    noteLock();
+    return findNext(next, "sem_wait")(semaphore);
+}
+}
+#else
+void* operator new(std::size_t size)
+{
+    noteAllocation();
+    if (auto* pointer = std::malloc(size == 0 ? 1 : size))
+        return pointer;
+
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete(void* pointer) noexcept
+{
+    if (pointer != nullptr)
+        noteAllocation();
+
+    std::free(pointer);
+}
+
+void operator delete[](void* pointer) noexcept
+{
+    operator delete(pointer);
+}
+
+void operator delete(void* pointer, std::size_t) noexcept
+{
+    operator delete(pointer);
+}
+
+void operator delete[](void* pointer, std::size_t) noexcept
+{
+    operator delete(pointer);
+}
+#endif
+
+//==============================================================================
+// Denormals. While processBlock runs, the SSE underflow and denormal-operand
+// exceptions are unmasked, so the first offending instruction raises SIGFPE.
+//
+// processBlock sets flush-to-zero and denormals-are-zero, and with those on
+// no instruction ever sees a denormal operand. An underflow still traps, but
+// its result was flushed to zero at no cost, e.g. a filter tail decaying in
+// silence; those are only counted. A denormal operand, or an underflow with
+// flush-to-zero off, is real denormal arithmetic and fails the run.
+//
+// The handler masks the exception that fired and returns, so the instruction
+// runs again and gives exactly the result it would have given untrapped. The
+// masks come back with the next block.
+#if OBLITERATOR_TRAP_DENORMALS
+namespace
+{
+constexpr unsigned int denormalFlag = 1u << 1;
+constexpr unsigned int underflowFlag = 1u << 4;
+constexpr unsigned int exceptionFlags = 0x3f;
+constexpr unsigned int denormalMask = 1u << 8;
+constexpr unsigned int underflowMask = 1u << 11;
+constexpr unsigned int flushToZero = 1u << 15;
+
+std::atomic<uintptr_t> firstDenormalAddress { 0 };
+
+void onFloatingPointException(int, siginfo_t* info, void* context)
+{
+    // Anything else, e.g. an integer division by zero, gets the default
+    // action once the instruction runs again
+    if (info->si_code != FPE_FLTUND)
+    {
+        std::signal(SIGFPE, SIG_DFL);
+        return;
+    }
+
+    auto* machineContext = &static_cast<ucontext_t*>(context)->uc_mcontext;
+    auto& mxcsr = machineContext->fpregs->mxcsr;
+
+    if ((mxcsr & denormalFlag) == 0 && (mxcsr & flushToZero) != 0)
+    {
+        violations.flushedUnderflows.fetch_add(1, std::memory_order_relaxed);
+        mxcsr |= underflowMask;
+    }
+    else
+    {
+        violations.denormals.fetch_add(1, std::memory_order_relaxed);
+        uintptr_t expected = 0;
+        firstDenormalAddress.compare_exchange_strong(expected, static_cast<uintptr_t>(machineContext->gregs[REG_RIP]));
+        mxcsr |= underflowMask | denormalMask;
+    }
+
+    mxcsr &= ~exceptionFlags;
+}
+
+void installDenormalTrap()
+{
+    struct sigaction action {};
+    action.sa_sigaction = onFloatingPointException;
+    action.sa_flags = SA_SIGINFO;
+    sigemptyset(&action.sa_mask);
+    sigaction(SIGFPE, &action, nullptr);
+}
+} // namespace
+#endif
+
+namespace
+{
+// Wraps exactly one processBlock call
+class ScopedRealtimeChecks
+{
+public:
+    ScopedRealtimeChecks()
+    {
+       #if OBLITERATOR_TRAP_DENORMALS
+        savedControl = _mm_getcsr();
+        _mm_setcsr(savedControl & ~(underflowMask | denormalMask | exceptionFlags));
+       #endif
+        insideProcessBlock = true;
+    }
+
+    ~ScopedRealtimeChecks()
+    {
+        insideProcessBlock = false;
+       #if OBLITERATOR_TRAP_DENORMALS
+        _mm_setcsr(savedControl);
+       #endif
+    }
+
+private:
+   #if OBLITERATOR_TRAP_DENORMALS
+    unsigned int savedControl = 0;
+   #endif
+
+    JUCE_DECLARE_NON_COPYABLE(ScopedRealtimeChecks)
+};
+
+//==============================================================================
+struct Options
+{
+    int numBlocks = 20000;  // Per phase
+    uint32_t seed = 1;
+    double sampleRate = 48000.0;
+    int blockSize = 512;
+    int numChannels = 2;
+};
+
+struct PhaseResult
+{
+    const char* name = "";
+    int numBlocks = 0;
+    int64_t numSamples = 0;
+    std::vector<double> blockNs;
+    double worstLoad = 0.0;   // Processing time / real time of the block
+    int worstLoadBlockSize = 0;
+    int overruns = 0;         // Blocks that took longer than they last
+    int64_t nonFiniteSamples = 0;
+    int64_t subnormalSamples = 0;
+};
+
+// Block sizes a host may send: single samples, odd splits around automation
+// points, the prepared size, and more than was promised in prepareToPlay
+int nextBlockSize(std::mt19937& random, int blockSize)
+{
+    switch (random() % 10)
+    {
+        case 0:  return 1;
+        case 1:
+        case 2:  return 1 + 2 * static_cast<int>(random() % static_cast<uint32_t>((std::min(blockSize, 127) + 1) / 2));
+        case 3:  return blockSize;
+        case 4:
+        case 5:  return blockSize + 1 + static_cast<int>(random() % static_cast<uint32_t>(3 * blockSize));
+        default: return 1 + static_cast<int>(random() % static_cast<uint32_t>(blockSize));
+    }
+}
+
+//==============================================================================
+// Automation the way JUCE's plugin wrappers deliver it: the new value is set
+// and the listeners told on the audio thread, just before processBlock.
+// Continuous parameters jump on every block; the switches move every so
+// often, so every algorithm, precision and antialiasing mode takes turns
+// with fresh filter and waveshaper state.
+class AutomationStorm
+{
+public:
+    explicit AutomationStorm(AudioPluginAudioProcessor& processor)
+    {
+        for (auto* id : { "drive", "asymmetry", "suboctave", "drywet", "tone", "folddepth" })
+            continuous.push_back(processor.parameters.getParameter(id));
+
+        switches.push_back({ processor.parameters.getParameter("algorithm"), 16 });
+        switches.push_back({ processor.parameters.getParameter("precision"), 40 });
+        switches.push_back({ processor.parameters.getParameter("antialiasing"), 40 });
+        switches.push_back({ processor.parameters.getParameter("bypass"), 80 });
+    }
+
+    void apply(std::mt19937& random)
+    {
+        std::uniform_real_distribution<float> value(0.0f, 1.0f);
+
+        for (auto* parameter : continuous)
+            set(*parameter, value(random));
+
+        for (auto& control : switches)
+            if (random() % control.blocksBetweenChanges == 0)
+                set(*control.parameter, value(random));
+    }
+
+private:
+    struct Switch
+    {
+        juce::AudioProcessorParameter* parameter;
+        uint32_t blocksBetweenChanges;
+    };
+
+    static void set(juce::AudioProcessorParameter& parameter, float normalisedValue)
+    {
+        parameter.setValue(normalisedValue);
+        parameter.sendValueChangedMessageToListeners(normalisedValue);
+    }
+
+    std::vector<juce::AudioProcessorParameter*> continuous;
+    std::vector<Switch> switches;
+};
+
+//==============================================================================
+// Input that changes character every few hundred blocks: full-scale noise,
+// a chord of sines, digital silence (the idle fast path and filter tails),
+// and a signal hovering just above the denormal range
+class TestSignal
+{
+public:
+    template <typename SampleType>
+    void render(juce::AudioBuffer<SampleType>& buffer, std::mt19937& random)
+    {
+        if (--blocksLeft <= 0)
+        {
+            kind = static_cast<Kind>(random() % 4);
+            blocksLeft = 100 + static_cast<int>(random() % 400);
+        }
+
+        std::uniform_real_distribution<SampleType> noise(SampleType(-1), SampleType(1));
+
+        for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+        {
+            auto* samples = buffer.getWritePointer(channel);
+            for (int i = 0; i < buffer.getNumSamples(); ++i)
+            {
+                const double t = static_cast<double>(position + i);
+                switch (kind)
+                {
+                    case Kind::Noise:   samples[i] = noise(random); break;
+                    case Kind::Sines:   samples[i] = static_cast<SampleType>(0.4 * std::sin(0.0143 * t + channel)
+                                                                           + 0.3 * std::sin(0.0917 * t)
+                                                                           + 0.2 * std::sin(0.4471 * t)); break;
+                    case Kind::Silence: samples[i] = SampleType(0); break;
+                    case Kind::Tiny:    samples[i] = SampleType(1.0e-30) * noise(random); break;
+                }
+            }
+        }
+
+        position += buffer.getNumSamples();
+    }
+
+private:
+    enum class Kind
+    {
+        Noise,
+        Sines,
+        Silence,
+        Tiny
+    };
+
+    Kind kind = Kind::Noise;
+    int blocksLeft = 0;
+    int64_t position = 0;
+};
+
+//==============================================================================
+// Stands in for the editor on the message thread. A real editor needs a
+// display, so this drives the same processor-side interfaces the editor's
+// components use, at a frame-like rate, and opens and closes "the editor"
+// at random.
+class EditorSimulator : private juce::Timer
+{
+public:
+    EditorSimulator(AudioPluginAudioProcessor& processorToUse, uint32_t seed)
+        : processor(processorToUse), random(seed)
+    {
+        pairs.resize(AnalysisRing::capacity);
+        startTimerHz(120);
+    }
+
+    ~EditorSimulator() override
+    {
+        stopTimer();
+        if (reader != nullptr)
+            detach();
+    }
+
+    int getNumAttaches() const { return numAttaches; }
+    int getNumStateRestores() const { return numStateRestores; }
+
+private:
+    void attach()
+    {
+        reader = std::make_unique<AnalysisRing::Reader>(processor.getOutputAnalysis());
+        processor.getSpectrumAnalyzer().addClient();
+        ++numAttaches;
+    }
+
+    void detach()
+    {
+        processor.getSpectrumAnalyzer().removeClient();
+        reader.reset();
+    }
+
+    void timerCallback() override
+    {
+        if (random() % 16 == 0)
+        {
+            if (reader != nullptr)
+                detach();
+            else
+                attach();
+        }
+
+        if (reader != nullptr)
+        {
+            reader->read(pairs.data(), AnalysisRing::capacity);
+            juce::ignoreUnused(processor.getSpectrumAnalyzer().getSnapshot());
+
+            auto& meters = processor.getLevelMeters();
+            for (int channel = 0; channel < meters.getNumChannels(); ++channel)
+            {
+                meters.takePeak(LevelMeters::Point::Input, channel);
+                meters.takePeak(LevelMeters::Point::Output, channel);
+                meters.getSaturationDb(channel);
+            }
+
+            juce::ignoreUnused(InstanceLoadTable::getInstance().getEntries());
+
+           #if OBLITERATOR_PROFILING
+            auto& profiler = processor.getProfiler();
+            juce::ignoreUnused(profiler.getBlockStatistics());
+            if (random() % 64 == 0)
+                profiler.requestReset();
+            if (random() % 256 == 0)
+                juce::ignoreUnused(profiler.createChromeTrace());
+           #endif
+        }
+
+        // Not automatable, so only ever changed from the editor
+        std::uniform_real_distribution<float> value(0.0f, 1.0f);
+        if (random() % 60 == 0)
+            processor.parameters.getParameter("oversampling")->setValueNotifyingHost(value(random));
+        if (random() % 120 == 0)
+            processor.parameters.getParameter("osphase")->setValueNotifyingHost(value(random));
+
+        // A host saving or loading a preset during playback
+        if (random() % 240 == 0)
+        {
+            juce::MemoryBlock state;
+            processor.getStateInformation(state);
+            processor.setStateInformation(state.getData(), static_cast<int>(state.getSize()));
+            ++numStateRestores;
+        }
+    }
+
+    AudioPluginAudioProcessor& processor;
+    std::mt19937 random;
+    std::unique_ptr<AnalysisRing::Reader> reader;
+    std::vector<AnalysisRing::MinMax> pairs;
+    int numAttaches = 0;
+    int numStateRestores = 0;
+};
+
+//==============================================================================
+// Runs on the message thread and waits for it, as a host does around
+// prepareToPlay
+void callOnMessageThread(std::function<void()> function)
+{
+    juce::WaitableEvent done;
+    juce::MessageManager::callAsync([&]
+    {
+        function();
+        done.signal();
+    });
+    done.wait();
+}
+
+template <typename SampleType>
+PhaseResult runPhase(AudioPluginAudioProcessor& processor, const Options& options, std::mt19937& random)
+{
+    PhaseResult result;
+    result.name = std::is_same_v<SampleType, double> ? "double" : "float";
+
+    callOnMessageThread([&]
+    {
+        processor.releaseResources();
+        processor.setProcessingPrecision(std::is_same_v<SampleType, double> ? juce::AudioProcessor::doublePrecision
+                                                                            : juce::AudioProcessor::singlePrecision);
+        processor.setPlayConfigDetails(options.numChannels, options.numChannels, options.sampleRate, options.blockSize);
+        processor.prepareToPlay(options.sampleRate, options.blockSize);
+    });
+
+    const int maxBlockSize = 4 * options.blockSize;
+    juce::AudioBuffer<SampleType> buffer(options.numChannels, maxBlockSize);
+    juce::MidiBuffer midi;
+    AutomationStorm storm(processor);
+    TestSignal signal;
+    bool hostBypassed = false;
+
+    result.blockNs.reserve(static_cast<size_t>(options.numBlocks));
+
+    for (int block = 0; block < options.numBlocks; ++block)
+    {
+        const int numSamples = nextBlockSize(random, options.blockSize);
+        buffer.setSize(options.numChannels, numSamples, false, false, true);
+        signal.render(buffer, random);
+        storm.apply(random);
+
+        if (random() % 200 == 0)
+            hostBypassed = ! hostBypassed;
+
+        const auto start = std::chrono::steady_clock::now();
+        {
+            const ScopedRealtimeChecks checks;
+            if (hostBypassed)
+                processor.processBlockBypassed(buffer, midi);
+            else
+                processor.processBlock(buffer, midi);
+        }
+        const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+
+        const double load = elapsed.count() / (1.0e9 * numSamples / options.sampleRate);
+        if (load > result.worstLoad)
+        {
+            result.worstLoad = load;
+            result.worstLoadBlockSize = numSamples;
+        }
+        result.overruns += load > 1.0 ? 1 : 0;
+        result.blockNs.push_back(elapsed.count());
+        result.numSamples += numSamples;
+
+        for (int channel = 0; channel < options.numChannels; ++channel)
+        {
+            const auto* samples = buffer.getReadPointer(channel);
+            for (int i = 0; i < numSamples; ++i)
+            {
+                const auto category = std::fpclassify(samples[i]);
+                result.nonFiniteSamples += (category == FP_NAN || category == FP_INFINITE) ? 1 : 0;
+                result.subnormalSamples += category == FP_SUBNORMAL ? 1 : 0;
+            }
+        }
+    }
+
+    result.numBlocks = options.numBlocks;
+    return result;
+}
+
+double getPercentile(const std::vector<double>& sorted, double percentile)
+{
+    if (sorted.empty())
+        return 0.0;
+
+    const auto rank = static_cast<size_t>(std::ceil(percentile / 100.0 * static_cast<double>(sorted.size())));
+    return sorted[std::min(sorted.size(), std::max<size_t>(rank, 1)) - 1];
+}
+
+void printPhase(PhaseResult& result, double sampleRate)
+{
+    std::sort(result.blockNs.begin(), result.blockNs.end());
+
+    std::cout << std::fixed << std::setprecision(1)
+              << result.name << ": " << result.numBlocks << " blocks, "
+              << result.numSamples / sampleRate << " s of audio\n"
+              << "  block time us: p50 " << getPercentile(result.blockNs, 50.0) * 1.0e-3
+              << "  p99 " << getPercentile(result.blockNs, 99.0) * 1.0e-3
+              << "  p99.9 " << getPercentile(result.blockNs, 99.9) * 1.0e-3
+              << "  max " << (result.blockNs.empty() ? 0.0 : result.blockNs.back()) * 1.0e-3 << "\n"
+              << "  worst load " << result.worstLoad * 100.0 << "% of a " << result.worstLoadBlockSize
+              << "-sample block, " << result.overruns << " blocks over their deadline\n";
+
+    if (result.nonFiniteSamples > 0 || result.subnormalSamples > 0)
+        std::cout << "  output: " << result.nonFiniteSamples << " NaN/inf samples, "
+                  << result.subnormalSamples << " subnormal samples\n";
+}
+} // namespace
+
+//==============================================================================
+int main(int argc, char* argv[])
+{
+    juce::ArgumentList arguments(argc, argv);
+    Options options;
+
+    const auto readOption = [&arguments](const char* name, auto fallback)
+    {
+        const auto value = arguments.getValueForOption(name);
+        return value.isEmpty() ? fallback : static_cast<decltype(fallback)>(value.getDoubleValue());
+    };
+
+    options.numBlocks = juce::jmax(1, readOption("--blocks", options.numBlocks));
+    options.seed = readOption("--seed", options.seed);
+    options.sampleRate = juce::jmax(8000.0, readOption("--sample-rate", options.sampleRate));
+    options.blockSize = juce::jmax(1, readOption("--block-size", options.blockSize));
+    options.numChannels = juce::jlimit(1, 16, readOption("--channels", options.numChannels));
+
+   #if OBLITERATOR_HOOK_LIBC
+    // The first call loads the unwinder, which allocates
+    void* warmUp[2];
+    backtrace(warmUp, 2);
+   #endif
+   #if OBLITERATOR_TRAP_DENORMALS
+    installDenormalTrap();
+   #endif
+
+    const juce::ScopedJuceInitialiser_GUI juceInitialiser;
+    auto processor = std::make_unique<AudioPluginAudioProcessor>();
+
+    if (! processor->setPlayConfigDetails(options.numChannels, options.numChannels,
+                                          options.sampleRate, options.blockSize))
+    {
+        std::cerr << "The processor does not support " << options.numChannels << " channels\n";
+        return 1;
+    }
+
+    auto editor = std::make_unique<EditorSimulator>(*processor, options.seed + 1);
+    std::vector<PhaseResult> results;
+
+    // The audio thread drives the test and stops the message loop when done
+    std::thread audioThread([&]
+    {
+        std::mt19937 random(options.seed);
+        results.push_back(runPhase<float>(*processor, options, random));
+        results.push_back(runPhase<double>(*processor, options, random));
+
+        juce::MessageManager::callAsync([] { juce::MessageManager::getInstance()->stopDispatchLoop(); });
+    });
+
+    juce::MessageManager::getInstance()->runDispatchLoop();
+    audioThread.join();
+
+    std::cout << "Seed " << options.seed << ", " << options.sampleRate << " Hz, prepared for "
+              << options.blockSize << " samples, " << options.numChannels << " channels; editor opened "
+              << editor->getNumAttaches() << " times, state restored " << editor->getNumStateRestores() << " times\n";
+
+    editor.reset();
+    processor.reset();
+
+    bool badOutput = false;
+    for (auto& result : results)
+    {
+        printPhase(result, options.sampleRate);
+        badOutput = badOutput || result.nonFiniteSamples > 0 || result.subnormalSamples > 0;
+    }
+
+    const auto allocations = violations.allocations.load();
+    const auto locks = violations.locks.load();
+    const auto denormals = violations.denormals.load();
+
+    std::cout << "In processBlock: " << allocations << " allocations, ";
+   #if OBLITERATOR_HOOK_LIBC
+    std::cout << locks << " locks, ";
+   #else
+    std::cout << "locks not checked on this platform, ";
+   #endif
+   #if OBLITERATOR_TRAP_DENORMALS
+    std::cout << denormals << " denormal traps (" << violations.flushedUnderflows.load()
+              << " underflows flushed to zero)\n";
+   #else
+    std::cout << "denormals only checked in the output on this platform\n";
+   #endif
+
+    if (firstViolationKind != nullptr)
+    {
+        std::cout << "First " << firstViolationKind << ":\n" << std::flush;
+       #if OBLITERATOR_HOOK_LIBC
+        backtrace_symbols_fd(firstViolationTrace, firstViolationDepth, STDOUT_FILENO);
+       #endif
+    }
+
+   #if OBLITERATOR_TRAP_DENORMALS
+    if (auto address = firstDenormalAddress.load(); address != 0)
+    {
+        std::cout << "First denormal at:\n" << std::flush;
+        void* frame[] { reinterpret_cast<void*>(address) };
+        backtrace_symbols_fd(frame, 1, STDOUT_FILENO);
+    }
+   #endif
+
+    const bool failed = allocations > 0 || locks > 0 || denormals > 0 || badOutput;
+    std::cout << (failed ? "FAILED" : "PASSED") << std::endl;
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,183 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
+//==============================================================================
+// Decimated signal history for the editor's displays. The audio thread
+// reduces every run of samplesPerPair samples to a min/max pair and appends
+// it to a fixed ring. Any number of GUI readers (scope, meters, analyzer)
+// follow the ring at their own pace through a Reader, with no locks on
+// either side.
+//
+// The writer never waits. A reader that falls more than a ring behind skips
+// ahead, and pairs overwritten while a reader was copying them are detected
+// and dropped (the writer announces how far it is about to write before it
+// starts, as in a seqlock). Pairs are packed into 64-bit atomics, so every
+// load sees a whole pair.
+//
+// While no Reader exists, push() returns straight away.
+class AnalysisRing
+{
+public:
+    struct MinMax
+    {
+        float min;
+        float max;
+    };
+
+    // About 0.7 s of history at the target rate; readers drain it every frame
+    static constexpr int capacity = 1 << 14;
+    static constexpr double targetPairRate = 24000.0;
+
+    AnalysisRing()
+    {
+        for (auto& slot : slots)
+            slot.store(pack({}), std::memory_order_relaxed);
+    }
+
+    // Picks the decimation for the sample rate. Called while the audio
+    // thread is stopped.
+    void prepare(double sampleRate)
+    {
+        samplesPerPair = std::max(1, static_cast<int>(std::lround(sampleRate / targetPairRate)));
+        pairRate.store(sampleRate / samplesPerPair, std::memory_order_relaxed);
+        clearPending();
+    }
+
+    // Pairs per second, for readers turning positions into time
+    double getPairRate() const { return pairRate.load(std::memory_order_relaxed); }
+
+    //==============================================================================
+    // Audio thread only. Wait-free, and free when nobody is reading.
+    template <typename SampleType>
+    void push(const SampleType* data, int numSamples)
+    {
+        if (numReaders.load(std::memory_order_relaxed) == 0)
+            return;
+
+        const auto start = writePosition.load(std::memory_order_relaxed);
+        const auto numPairs = static_cast<uint64_t>((pendingCount + numSamples) / samplesPerPair);
+
+        if (numPairs > 0)
+        {
+            claimedPosition.store(start + numPairs, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+        }
+
+        auto position = start;
+        for (int offset = 0; offset < numSamples;)
+        {
+            const int run = std::min(samplesPerPair - pendingCount, numSamples - offset);
+
+            float runMin = pendingMin, runMax = pendingMax;
+            for (int i = 0; i < run; ++i)
+            {
+                const auto sample = static_cast<float>(data[offset + i]);
+                runMin = std::min(runMin, sample);
+                runMax = std::max(runMax, sample);
+            }
+
+            offset += run;
+            pendingCount += run;
+            pendingMin = runMin;
+            pendingMax = runMax;
+
+            if (pendingCount == samplesPerPair)
+            {
+                slots[position++ & mask].store(pack({ pendingMin, pendingMax }), std::memory_order_relaxed);
+                clearPending();
+            }
+        }
+
+        if (numPairs > 0)
+            writePosition.store(position, std::memory_order_release);
+    }
+
+    //==============================================================================
+    // A cursor into the ring for one GUI consumer. It starts at the newest
+    // pair, and keeps push() running for as long as it exists.
+    class Reader
+    {
+    public:
+        explicit Reader(AnalysisRing& source)
+            : ring(source), position(source.writePosition.load(std::memory_order_acquire))
+        {
+            ring.numReaders.fetch_add(1);
+        }
+
+        ~Reader() { ring.numReaders.fetch_sub(1); }
+
+        // Copies the pairs published since the last call into dest, oldest
+        // first, and returns how many there were. When more than maxPairs
+        // are waiting only the newest maxPairs are kept.
+        int read(AnalysisRing::MinMax* dest, int maxPairs)
+        {
+            const auto end = ring.writePosition.load(std::memory_order_acquire);
+            const auto available = std::min<uint64_t>(end - position, static_cast<uint64_t>(std::min(maxPairs, capacity)));
+            position = end - available;
+
+            for (uint64_t i = 0; i < available; ++i)
+                dest[i] = unpack(ring.slots[(position + i) & mask].load(std::memory_order_relaxed));
+
+            // Anything the writer has claimed since may have overwritten the
+            // oldest pairs while they were being copied
+            std::atomic_thread_fence(std::memory_order_acquire);
+            const auto claimed = ring.claimedPosition.load(std::memory_order_relaxed);
+            const auto firstIntact = claimed > static_cast<uint64_t>(capacity) ? claimed - capacity : 0;
+            const auto torn = firstIntact > position ? std::min(firstIntact - position, available) : 0;
+
+            if (torn > 0)
+                std::memmove(dest, dest + torn, static_cast<size_t>(available - torn) * sizeof(MinMax));
+
+            position = end;
+            return static_cast<int>(available - torn);
+        }
+
+    private:
+        AnalysisRing& ring;
+        uint64_t position;
+    };
+
+private:
+    static constexpr uint64_t mask = capacity - 1;
+
+    static uint64_t pack(MinMax pair)
+    {
+        uint64_t bits;
+        static_assert(sizeof(bits) == sizeof(pair), "A pair must fit one atomic word");
+        std::memcpy(&bits, &pair, sizeof(bits));
+        return bits;
+    }
+
+    static MinMax unpack(uint64_t bits)
+    {
+        MinMax pair {};
+        std::memcpy(&pair, &bits, sizeof(pair));
+        return pair;
+    }
+
+    void clearPending()
+    {
+        pendingCount = 0;
+        pendingMin = std::numeric_limits<float>::max();
+        pendingMax = std::numeric_limits<float>::lowest();
+    }
+
+    std::array<std::atomic<uint64_t>, capacity> slots;
+    std::atomic<uint64_t> writePosition { 0 };
+    std::atomic<uint64_t> claimedPosition { 0 };
+    std::atomic<int> numReaders { 0 };
+    std::atomic<double> pairRate { targetPairRate };
+
+    // Audio thread state for the pair being accumulated
+    int samplesPerPair = 1;
+    int pendingCount = 0;
+    float pendingMin = std::numeric_limits<float>::max();
+    float pendingMax = std::numeric_limits<float>::lowest();
+};
@@ -0,0 +1,166 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+
+//==============================================================================
+// Antiderivative anti-aliasing (ADAA). Instead of sampling the waveshaper's
+// transfer function f at each input, the output is the average of f over the
+// segment between consecutive inputs, computed from its antiderivatives.
+// That suppresses most aliasing at a fraction of the cost of oversampling,
+// with no filters and no buffers, only the last two inputs per channel.
+//
+// First order adds half a sample of group delay, second order one sample.
+// Both are fractional/negligible, so they are not reported to the host.
+enum class AntialiasingMode
+{
+    Off = 0,
+    FirstOrder = 1,
+    SecondOrder = 2
+};
+
+constexpr int numAntialiasingModes = 3;
+
+// Per-channel history: the last two waveshaper inputs. Inputs rather than
+// antiderivative values are kept, so the history stays valid when drive or
+// asymmetry change between blocks. Stored in double so float and double
+// samples both fit exactly.
+struct AntialiasingState
+{
+    double x1 = 0.0;
+    double x2 = 0.0;
+};
+
+namespace ADAA
+{
+    // Below this distance between inputs, relative to their size in the
+    // waveshaper's own input domain, the divided differences lose too much
+    // precision, and the formulas fall back to evaluating the function at the
+    // segment midpoint. The threshold has to scale: F1 grows like |u| and F2
+    // like u^2, so their rounding error at drive 1000 is millions of times
+    // what it is near 0. Everything runs in double for the same reason.
+    constexpr double tolerance = 1.0e-5;
+
+    // Second order divides twice, so its rounding error goes with
+    // 1 / tolerance^2 and needs a wider margin to stay below -140 dB
+    constexpr double secondOrderTolerance = 1.0e-4;
+
+    inline bool isIllConditioned(double delta, double magnitude, double relativeTolerance)
+    {
+        return std::abs(delta) < relativeTolerance * std::max(1.0, magnitude);
+    }
+
+    // Li2(-z) for z in [0, 1], through the Landen identity
+    // Li2(-z) = -Li2(w) - ln(1 + z)^2 / 2 with w = z / (1 + z) <= 0.5, and the
+    // Bernoulli series of Li2(w) in y = -ln(1 - w) <= ln 2.
+    // Absolute error below 1e-12.
+    inline double dilogarithmOfNegative(double z)
+    {
+        const double logOnePlusZ = std::log1p(z);
+        const double y = logOnePlusZ; // -ln(1 - z / (1 + z)) == ln(1 + z)
+        const double y2 = y * y;
+
+        const double li2w = y - 0.25 * y2
+                          + y * y2 * (1.0 / 36.0
+                          + y2 * (-1.0 / 3600.0
+                          + y2 * (1.0 / 211680.0
+                          + y2 * (-1.0 / 10886400.0
+                          + y2 * (1.0 / 526901760.0
+                          + y2 * (-4.0647616451442255e-11))))));
+
+        return -li2w - 0.5 * logOnePlusZ * logOnePlusZ;
+    }
+
+    //==============================================================================
+    // The Shaper must provide:
+    //   toShaperDomain(input)  maps an input sample to u, the argument of f
+    //   transfer(u)            f(u), without the output gain
+    //   antiderivative1(u)     F1(u), with F1' = f
+    //   antiderivative2(u)     F2(u), with F2' = F1 (second order only)
+    //   outputGain             applied after f, as a double
+    // The divided differences are invariant to the linear input mapping, so
+    // the whole computation can run in u.
+
+    template <typename Shaper, typename SampleType>
+    void processFirstOrder(const Shaper& shaper, AntialiasingState& state,
+                           SampleType* data, int numSamples)
+    {
+        double u1 = shaper.toShaperDomain(state.x1);
+        double previousAntiderivative = shaper.antiderivative1(u1);
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const double x = data[i];
+            const double u = shaper.toShaperDomain(x);
+            const double antiderivative = shaper.antiderivative1(u);
+            const double delta = u - u1;
+
+            const double y = isIllConditioned(delta, std::max(std::abs(u), std::abs(u1)), tolerance)
+                           ? shaper.transfer(0.5 * (u + u1))
+                           : (antiderivative - previousAntiderivative) / delta;
+
+            data[i] = static_cast<SampleType>(y * Shaper::outputGain);
+
+            state.x2 = state.x1;
+            state.x1 = x;
+            u1 = u;
+            previousAntiderivative = antiderivative;
+        }
+    }
+
+    template <typename Shaper, typename SampleType>
+    void processSecondOrder(const Shaper& shaper, AntialiasingState& state,
+                            SampleType* data, int numSamples)
+    {
+        // First divided difference of F2, i.e. the mean of F1 over [u1, u0]
+        const auto dividedDifference = [&shaper](double u0, double u1, double f0, double f1)
+        {
+            const double delta = u0 - u1;
+            return isIllConditioned(delta, std::max(std::abs(u0), std::abs(u1)), secondOrderTolerance)
+                 ? shaper.antiderivative1(0.5 * (u0 + u1))
+                 : (f0 - f1) / delta;
+        };
+
+        double u1 = shaper.toShaperDomain(state.x1);
+        double u2 = shaper.toShaperDomain(state.x2);
+        double previousAntiderivative = shaper.antiderivative2(u1);
+        double previousDifference = dividedDifference(u1, u2, previousAntiderivative,
+                                                      shaper.antiderivative2(u2));
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const double x = data[i];
+            const double u = shaper.toShaperDomain(x);
+            const double antiderivative = shaper.antiderivative2(u);
+            const double difference = dividedDifference(u, u1, antiderivative, previousAntiderivative);
+
+            const double magnitude = std::max({ std::abs(u), std::abs(u1), std::abs(u2) });
+
+            double y;
+            if (! isIllConditioned(u - u2, magnitude, secondOrderTolerance))
+            {
+                y = 2.0 * (difference - previousDifference) / (u - u2);
+            }
+            else
+            {
+                // u0 and u2 coincide: expand around their midpoint instead
+                const double uBar = 0.5 * (u + u2);
+                const double delta = uBar - u1;
+
+                y = isIllConditioned(delta, magnitude, secondOrderTolerance)
+                  ? shaper.transfer(0.5 * (uBar + u1))
+                  : (2.0 / delta) * (shaper.antiderivative1(uBar)
+                                     + (previousAntiderivative - shaper.antiderivative2(uBar)) / delta);
+            }
+
+            data[i] = static_cast<SampleType>(y * Shaper::outputGain);
+
+            state.x2 = state.x1;
+            state.x1 = x;
+            u2 = u1;
+            u1 = u;
+            previousAntiderivative = antiderivative;
+            previousDifference = difference;
+        }
+    }
+}
@@ -0,0 +1,918 @@
+#include "DistortionEngine.h"
+
+//==============================================================================
+template <typename SampleType>
+void DistortionEngine<SampleType>::prepare(double sampleRate, int maximumBlockSize,
+                                           int numChannels)
+{
+    currentSampleRate = sampleRate;
+    maxBlockSize = juce::jmax(1, maximumBlockSize);
+    numPreparedChannels = juce::jmax(0, numChannels);
+    dryBuffer.setSize(numPreparedChannels, maxBlockSize);
+    antialiasingState.assign(static_cast<size_t>(numPreparedChannels), {});
+    filterState.resize(numPreparedChannels);
+    interleavedScratch.assign(static_cast<size_t>(maxFilterLanes * maxBlockSize), SampleType(0));
+
+    driveSmoother.reset(sampleRate, smoothingTimeSeconds);
+    asymmetrySmoother.reset(sampleRate, smoothingTimeSeconds);
+    subOctaveSmoother.reset(sampleRate, smoothingTimeSeconds);
+    dryWetSmoother.reset(sampleRate, smoothingTimeSeconds);
+    toneSmoother.reset(sampleRate, smoothingTimeSeconds);
+    foldDepthSmoother.reset(sampleRate, smoothingTimeSeconds);
+    bypassGain.reset(sampleRate, bypassFadeSeconds);
+    mixGain.assign(static_cast<size_t>(maxBlockSize), SampleType(0));
+    inputLevels.assign(static_cast<size_t>(numPreparedChannels), {});
+    outputLevels.assign(static_cast<size_t>(numPreparedChannels), {});
+    chunkOutputLevels.assign(static_cast<size_t>(numPreparedChannels), {});
+
+    updateFilterCoefficients(sampleRate);
+
+    // Build every oversampler up front, with integer latency so the dry path
+    // and the host's delay compensation can line up exactly
+    int maxLatency = 0;
+    for (int phase = 0; phase < numOversamplingPhases; ++phase)
+    {
+        const auto filterType = phase == static_cast<int>(OversamplingPhase::Linear)
+                              ? Oversampler::filterHalfBandFIREquiripple
+                              : Oversampler::filterHalfBandPolyphaseIIR;
+
+        oversamplerLatency[phase][0] = 0;
+
+        for (int order = 1; order <= maxOversamplingOrder; ++order)
+        {
+            auto& oversampler = oversamplers[phase][order - 1];
+            oversampler = std::make_unique<Oversampler>(
+                    static_cast<size_t>(juce::jmax(1, numPreparedChannels)),
+                    static_cast<size_t>(order), filterType, true, true);
+            oversampler->initProcessing(static_cast<size_t>(maxBlockSize));
+
+            const int latency = juce::roundToInt(oversampler->getLatencyInSamples());
+            oversamplerLatency[phase][order] = latency;
+            maxLatency = juce::jmax(maxLatency, latency);
+        }
+    }
+
+    dryDelayBuffer.setSize(numPreparedChannels, maxLatency + maxBlockSize);
+
+    reset();
+}
+
+template <typename SampleType>
+void DistortionEngine<SampleType>::reset()
+{
+    resetProcessingState();
+
+    activeOversampler = getOversampler(targetParameters.oversamplingOrder,
+                                       targetParameters.oversamplingPhase);
+
+    dryDelayBuffer.clear();
+    dryDelayWritePosition = 0;
+    silentSamples = 0;
+
+    // Whatever arrives next is applied without a ramp
+    params = targetParameters;
+    snapToTargetParameters = true;
+}
+
+template <typename SampleType>
+void DistortionEngine<SampleType>::resetProcessingState()
+{
+    for (auto& state : antialiasingState)
+        state = {};
+    filterState.clear();
+
+    for (auto& phase : oversamplers)
+        for (auto& oversampler : phase)
+            if (oversampler != nullptr)
+                oversampler->reset();
+
+    silentSamples = 0;
+}
+
+template <typename SampleType>
+void DistortionEngine<SampleType>::setParameters(const Parameters& newParameters)
+{
+    targetParameters = newParameters;
+
+    if (snapToTargetParameters)
+    {
+        // Drive never goes below 1, which keeps the multiplicative ramp valid
+        driveSmoother.setCurrentAndTargetValue(newParameters.drive);
+        asymmetrySmoother.setCurrentAndTargetValue(newParameters.asymmetry);
+        subOctaveSmoother.setCurrentAndTargetValue(newParameters.subOctave);
+        dryWetSmoother.setCurrentAndTargetValue(newParameters.dryWet);
+        toneSmoother.setCurrentAndTargetValue(newParameters.tone);
+        foldDepthSmoother.setCurrentAndTargetValue(newParameters.foldDepth);
+        bypassGain.setCurrentAndTargetValue(newParameters.bypassed ? SampleType(1) : SampleType(0));
+        params = newParameters;
+        snapToTargetParameters = false;
+        return;
+    }
+
+    driveSmoother.setTargetValue(newParameters.drive);
+    asymmetrySmoother.setTargetValue(newParameters.asymmetry);
+    subOctaveSmoother.setTargetValue(newParameters.subOctave);
+    dryWetSmoother.setTargetValue(newParameters.dryWet);
+    toneSmoother.setTargetValue(newParameters.tone);
+    foldDepthSmoother.setTargetValue(newParameters.foldDepth);
+
+    // Coming back from a full bypass, the filters and oversamplers still
+    // hold whatever was playing when it started
+    if (! newParameters.bypassed && isFullyBypassed())
+        resetProcessingState();
+
+    bypassGain.setTargetValue(newParameters.bypassed ? SampleType(1) : SampleType(0));
+}
+
+template <typename SampleType>
+bool DistortionEngine<SampleType>::isFullyBypassed() const
+{
+    return bypassGain.getTargetValue() == SampleType(1) && ! bypassGain.isSmoothing();
+}
+
+template <typename SampleType>
+void DistortionEngine<SampleType>::updateFilterCoefficients(double sampleRate)
+{
+    jassert(sampleRate > 0.0);
+    const double twoPiOverRate = juce::MathConstants<double>::twoPi / sampleRate;
+
+    // One-pole poles matched to the corner frequency
+    coefficients.dcBlockerPole = static_cast<SampleType>(std::exp(-twoPiOverRate * dcBlockerCutoffHz));
+    coefficients.subOctaveSmoothing = static_cast<SampleType>(1.0 - std::exp(-twoPiOverRate * subOctaveSmoothingHz));
+    coefficients.toneLowpassSmoothing = static_cast<SampleType>(1.0 - std::exp(-twoPiOverRate * toneLowpassHz));
+    coefficients.toneHighpassPole = static_cast<SampleType>(std::exp(-twoPiOverRate * toneHighpassHz));
+
+    updateToneCoefficients();
+}
+
+template <typename SampleType>
+void DistortionEngine<SampleType>::updateToneCoefficients()
+{
+    // Blend from flat (0.5) to full lowpass (0.0) or full highpass (1.0)
+    coefficients.tone = params.tone;
+    coefficients.toneBlend = static_cast<SampleType>(std::abs(params.tone - 0.5f) * 2.0f);
+}
+
+template <typename SampleType>
+bool DistortionEngine<SampleType>::isSmoothing() const
+{
+    return driveSmoother.isSmoothing() || asymmetrySmoother.isSmoothing()
+        || subOctaveSmoother.isSmoothing() || dryWetSmoother.isSmoothing()
+        || toneSmoother.isSmoothing() || foldDepthSmoother.isSmoothing();
+}
+
+template <typename SampleType>
+void DistortionEngine<SampleType>::advanceSmoothers(int numSamples)
+{
+    // Switches follow the target straight away; the continuous values take
+    // where the ramps end up after this chunk
+    params = targetParameters;
+    params.drive = driveSmoother.skip(numSamples);
+    params.asymmetry = asymmetrySmoother.skip(numSamples);
+    params.subOctave = subOctaveSmoother.skip(numSamples);
+    params.dryWet = dryWetSmoother.skip(numSamples);
+    params.tone = toneSmoother.skip(numSamples);
+    params.foldDepth = foldDepthSmoother.skip(numSamples);
+}
+
+//==============================================================================
+template <typename SampleType>
+int DistortionEngine<SampleType>::getLatencySamples() const
+{
+    return getLatencySamples(targetParameters.oversamplingOrder, targetParameters.oversamplingPhase);
+}
+
+template <typename SampleType>
+int DistortionEngine<SampleType>::getLatencySamples(int oversamplingOrder, OversamplingPhase phase) const
+{
+    const int order = juce::jlimit(0, maxOversamplingOrder, oversamplingOrder);
+    const int phaseIndex = juce::jlimit(0, numOversamplingPhases - 1, static_cast<int>(phase));
+    return oversamplerLatency[phaseIndex][order];
+}
+
+template <typename SampleType>
+double DistortionEngine<SampleType>::getTailLengthSeconds() const
+{
+    // The DC blocker has the lowest corner, so it rings longest: a one-pole
+    // decays to silenceThreshold in ln(1 / threshold) time constants. The
+    // oversampling filters add up to twice their latency on top.
+    const double timeConstants = std::log(1.0 / silenceThreshold) / juce::MathConstants<double>::twoPi;
+    double decaySeconds = timeConstants / dcBlockerCutoffHz;
+
+    // The octave divider is put to rest once the DC blocker has decayed,
+    // and its smoothing lowpass then decays in turn
+    if (targetParameters.subOctave > 0.0f)
+        decaySeconds += timeConstants / subOctaveSmoothingHz;
+
+    return decaySeconds + 2.0 * getLatencySamples() / currentSampleRate;
+}
+
+template <typename SampleType>
+double DistortionEngine<SampleType>::getSmallSignalGain() const
+{
+    // Slope of each waveshaper at the origin, ignoring the asymmetry bias
+    const double drive = static_cast<double>(params.drive);
+    double shaperGain = 1.0;
+    if (params.drive > 1.0f)
+    {
+        switch (params.algorithm)
+        {
+            case DistortionType::Tanh:     shaperGain = drive; break;
+            case DistortionType::Foldback: shaperGain = std::sqrt(drive) * 0.8; break;
+            case DistortionType::Tube:     shaperGain = 5.0 * std::sqrt(drive) * 0.85; break;
+        }
+    }
+
+    const double wet = static_cast<double>(params.dryWet) * (1.0 - static_cast<double>(bypassGain.getCurrentValue()));
+    return wet * shaperGain + (1.0 - wet);
+}
+
+template <typename SampleType>
+bool DistortionEngine<SampleType>::isInputSilent(const SampleType* const* channelData,
+                                                 int numChannels, int numSamples) const
+{
+    if (numSamples <= 0)
+        return true;
+
+    // The waveshaper can amplify by up to max(drive, 5 sqrt(drive)), so the
+    // input has to sit that much lower to stay inaudible at the output
+    const double drive = juce::jmax(1.0, static_cast<double>(targetParameters.drive));
+    const auto threshold = static_cast<SampleType>(silenceThreshold / juce::jmax(drive, 5.0 * std::sqrt(drive)));
+
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+        const auto range = juce::FloatVectorOperations::findMinAndMax(channelData[channel], numSamples);
+        if (juce::jmax(-range.getStart(), range.getEnd()) >= threshold)
+            return false;
+    }
+
+    return true;
+}
+
+template <typename SampleType>
+bool DistortionEngine<SampleType>::exceedsSilence(const std::vector<SampleType>& values, int numChannels)
+{
+    if (numChannels <= 0)
+        return false;
+
+    const auto range = juce::FloatVectorOperations::findMinAndMax(values.data(), numChannels);
+    return juce::jmax(-range.getStart(), range.getEnd()) >= static_cast<SampleType>(silenceThreshold);
+}
+
+template <typename SampleType>
+bool DistortionEngine<SampleType>::hasDCBlockerDecayed(int numChannels) const
+{
+    // Only the DC blocker output carries over, and only while the blocker
+    // runs; its input history may hold the constant the waveshaper gives for
+    // silence when asymmetry is set
+    const bool dcBlockerActive = targetParameters.drive > 1.0f;
+    return ! (dcBlockerActive && exceedsSilence(filterState.dcY1, numChannels));
+}
+
+template <typename SampleType>
+bool DistortionEngine<SampleType>::hasStateDecayed(int numChannels) const
+{
+    // The sub-octave lowpass only reaches the output while the last chunk
+    // mixed it in; otherwise it is frozen until the sub-octave comes back
+    const bool subOctaveActive = params.subOctave > 0.0f;
+
+    return hasDCBlockerDecayed(numChannels)
+        && ! (subOctaveActive && exceedsSilence(filterState.subLowpassZ1, numChannels))
+        && ! exceedsSilence(filterState.toneLowpassZ1, numChannels)
+        && ! exceedsSilence(filterState.toneHighpassZ1, numChannels);
+}
+
+template <typename SampleType>
+typename DistortionEngine<SampleType>::Oversampler*
+DistortionEngine<SampleType>::getOversampler(int oversamplingOrder, OversamplingPhase phase) const
+{
+    const int order = juce::jlimit(0, maxOversamplingOrder, oversamplingOrder);
+    if (order == 0)
+        return nullptr;
+
+    const int phaseIndex = juce::jlimit(0, numOversamplingPhases - 1, static_cast<int>(phase));
+    return oversamplers[phaseIndex][order - 1].get();
+}
+
+//==============================================================================
+template <typename SampleType>
+void DistortionEngine<SampleType>::process(juce::AudioBuffer<SampleType>& buffer)
+{
+    process(buffer.getArrayOfWritePointers(), buffer.getNumChannels(),
+            buffer.getNumSamples());
+}
+
+template <typename SampleType>
+void DistortionEngine<SampleType>::process(SampleType* const* channelData, int numChannels,
+                               int numSamples)
+{
+    // prepare() must be called before processing, with enough channels
+    jassert(maxBlockSize > 0);
+    jassert(numChannels <= numPreparedChannels);
+    if (maxBlockSize <= 0)
+        return;
+
+    numChannels = juce::jmin(numChannels, numPreparedChannels);
+
+    for (auto* levels : { &inputLevels, &outputLevels })
+        for (auto& channelLevels : *levels)
+            channelLevels.clear();
+
+    // A newly selected oversampler starts from silence rather than from
+    // whatever it held the last time it was used
+    auto* oversampler = getOversampler(targetParameters.oversamplingOrder,
+                                       targetParameters.oversamplingPhase);
+    if (oversampler != activeOversampler)
+    {
+        if (oversampler != nullptr)
+            oversampler->reset();
+        activeOversampler = oversampler;
+    }
+
+    if (isFullyBypassed())
+    {
+        processingState = ProcessingState::Bypassed;
+        processBypassed(channelData, numChannels, numSamples);
+        return;
+    }
+
+    // Silent input into fully decayed state gives silence: skip the chain,
+    // only keeping any parameter ramps moving
+    const bool inputSilent = isInputSilent(channelData, numChannels, numSamples);
+    const bool inputFlushed = inputSilent && silentSamples >= 2 * getLatencySamples();
+
+    // The octave divider would hold its square wave through silence, as DC
+    // at the output. Once its input has decayed it is put to rest, so its
+    // lowpass decays with the rest of the state; the next rising edge after
+    // silence starts it again.
+    if (inputFlushed && hasDCBlockerDecayed(numChannels))
+        std::fill(filterState.subSquare.begin(), filterState.subSquare.end(), SampleType(0));
+
+    const bool idle = inputFlushed && hasStateDecayed(numChannels);
+    silentSamples = inputSilent ? juce::jmin(silentSamples + numSamples, std::numeric_limits<int>::max() / 2) : 0;
+    processingState = idle ? ProcessingState::Idle : ProcessingState::Processing;
+
+    if (idle)
+    {
+        for (int channel = 0; channel < numChannels; ++channel)
+            juce::FloatVectorOperations::clear(channelData[channel], numSamples);
+
+        if (isSmoothing())
+            advanceSmoothers(numSamples);
+        else
+            params = targetParameters;
+
+        bypassGain.skip(numSamples);
+        return;
+    }
+
+    const juce::dsp::AudioBlock<SampleType> block(channelData, static_cast<size_t>(numChannels),
+                                             static_cast<size_t>(numSamples));
+
+    // Nothing is ramping: one set of kernels and parameters for the whole
+    // buffer. Hosts may deliver more than the announced block size, so work
+    // through it in chunks that fit the scratch buffers.
+    if (! isSmoothing())
+    {
+        params = targetParameters;
+        if (params.tone != coefficients.tone)
+            updateToneCoefficients();
+
+        const auto shaperKernel = selectShaperKernel();
+        const auto& filterKernels = selectFilterKernels();
+
+        for (int offset = 0; offset < numSamples; offset += maxBlockSize)
+        {
+            const int blockSize = juce::jmin(maxBlockSize, numSamples - offset);
+            processChunk(block.getSubBlock(static_cast<size_t>(offset), static_cast<size_t>(blockSize)),
+                         shaperKernel, filterKernels, params.dryWet);
+        }
+
+        return;
+    }
+
+    // Ramping: step the parameters every smoothingInterval samples, which is
+    // short enough that drive and tone moves do not zipper
+    for (int offset = 0; offset < numSamples;)
+    {
+        const int blockSize = juce::jmin(smoothingInterval, maxBlockSize, numSamples - offset);
+        const float dryWetStart = dryWetSmoother.getCurrentValue();
+        advanceSmoothers(blockSize);
+        if (params.tone != coefficients.tone)
+            updateToneCoefficients();
+
+        processChunk(block.getSubBlock(static_cast<size_t>(offset), static_cast<size_t>(blockSize)),
+                     selectShaperKernel(), selectFilterKernels(), dryWetStart);
+        offset += blockSize;
+    }
+}
+
+template <typename SampleType>
+void DistortionEngine<SampleType>::processChunk(const juce::dsp::AudioBlock<SampleType>& block,
+                                                ShaperKernel shaperKernel, const FilterKernels& filterKernels,
+                                                float dryWetStart)
+{
+    const int numChannels = static_cast<int>(block.getNumChannels());
+    const int numSamples = static_cast<int>(block.getNumSamples());
+
+    // Store original dry signal, delayed to line up with the wet path,
+    // metering the input on the way
+    {
+        OBLITERATOR_PROFILE_STAGE(profiler, DspProfiler::Stage::DryCopy);
+
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            const auto* input = block.getChannelPointer(static_cast<size_t>(channel));
+            inputLevels[static_cast<size_t>(channel)].write(dryBuffer.getWritePointer(channel), numSamples,
+                                                            [input](int i) { return input[i]; });
+            chunkOutputLevels[static_cast<size_t>(channel)].clear();
+        }
+
+        delayDrySignal(numChannels, numSamples, getLatencySamples());
+    }
+
+    {
+        OBLITERATOR_PROFILE_STAGE(profiler, DspProfiler::Stage::Waveshaper);
+
+        // Nonlinear stage, optionally at a higher rate to keep the harmonics
+        // created by the waveshaper from aliasing back into the audio band
+        const WaveshaperParameters shaperParameters { params.drive, params.asymmetry, params.foldDepth };
+
+        if (activeOversampler != nullptr)
+        {
+            auto oversampledBlock = activeOversampler->processSamplesUp(block);
+
+            for (size_t channel = 0; channel < oversampledBlock.getNumChannels(); ++channel)
+                shaperKernel(shaperParameters, antialiasingState[channel],
+                             oversampledBlock.getChannelPointer(channel),
+                             static_cast<int>(oversampledBlock.getNumSamples()));
+
+            auto outputBlock = block;
+            activeOversampler->processSamplesDown(outputBlock);
+        }
+        else
+        {
+            for (size_t channel = 0; channel < block.getNumChannels(); ++channel)
+                shaperKernel(shaperParameters, antialiasingState[channel],
+                             block.getChannelPointer(channel), numSamples);
+        }
+    }
+
+    {
+        OBLITERATOR_PROFILE_STAGE(profiler, DspProfiler::Stage::Filters);
+
+        // Filter the channels in groups of maxFilterLanes, then a pair, then a
+        // single one, so stereo runs as one two-lane pass
+        SampleType* channels[maxFilterLanes] = {};
+        for (int channel = 0; channel < numChannels;)
+        {
+            const int remaining = numChannels - channel;
+            const int laneWidth = remaining >= maxFilterLanes ? 2 : remaining >= 2 ? 1 : 0;
+            const int lanes = laneWidth == 2 ? maxFilterLanes : laneWidth + 1;
+
+            for (int lane = 0; lane < lanes; ++lane)
+                channels[lane] = block.getChannelPointer(static_cast<size_t>(channel + lane));
+
+            (this->*filterKernels[static_cast<size_t>(laneWidth)])(channel, channels, numSamples);
+            channel += lanes;
+        }
+    }
+
+    {
+        OBLITERATOR_PROFILE_STAGE(profiler, DspProfiler::Stage::Mix);
+
+        // Dry/wet mix and bypass crossfade in one pass, re-metering the output:
+        // out = dry + gain * (wet - dry), with gain = dryWet * (1 - bypass)
+        // dryWet = 0.0 (left): 100% dry
+        // dryWet = 1.0 (right): 100% wet
+        const bool mixRamping = dryWetStart != params.dryWet || bypassGain.isSmoothing();
+        if (mixRamping || params.dryWet < 1.0f)
+        {
+            if (mixRamping)
+            {
+                // The dry/wet ramp is only ever one smoothingInterval long
+                jassert(dryWetStart == params.dryWet || numSamples <= smoothingInterval);
+                const auto start = static_cast<SampleType>(dryWetStart);
+                const auto step = (static_cast<SampleType>(params.dryWet) - start) / static_cast<SampleType>(numSamples);
+                for (int i = 0; i < numSamples; ++i)
+                    mixGain[static_cast<size_t>(i)] = (start + step * static_cast<SampleType>(i + 1))
+                                                    * (SampleType(1) - bypassGain.getNextValue());
+            }
+
+            const auto* gain = mixGain.data();
+            const auto wet = static_cast<SampleType>(params.dryWet);
+
+            for (int channel = 0; channel < numChannels; ++channel)
+            {
+                auto* data = block.getChannelPointer(static_cast<size_t>(channel));
+                const auto* dry = dryBuffer.getReadPointer(channel);
+                auto& levels = chunkOutputLevels[static_cast<size_t>(channel)];
+                levels.clear();
+
+                if (mixRamping)
+                    levels.write(data, numSamples, [=](int i) { return dry[i] + gain[i] * (data[i] - dry[i]); });
+                else
+                    levels.write(data, numSamples, [=](int i) { return dry[i] + wet * (data[i] - dry[i]); });
+            }
+        }
+    }
+
+    for (int channel = 0; channel < numChannels; ++channel)
+        outputLevels[static_cast<size_t>(channel)].merge(chunkOutputLevels[static_cast<size_t>(channel)]);
+}
+
+template <typename SampleType>
+void DistortionEngine<SampleType>::processBypassed(SampleType* const* channelData,
+                                                   int numChannels, int numSamples)
+{
+    // Copy-only path: the input goes through the dry delay, so the output
+    // stays aligned with the latency the host compensates for
+    OBLITERATOR_PROFILE_STAGE(profiler, DspProfiler::Stage::DryCopy);
+    const int latency = getLatencySamples();
+
+    for (int offset = 0; offset < numSamples; offset += maxBlockSize)
+    {
+        const int blockSize = juce::jmin(maxBlockSize, numSamples - offset);
+
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            const auto* input = channelData[channel] + offset;
+            inputLevels[static_cast<size_t>(channel)].write(dryBuffer.getWritePointer(channel), blockSize,
+                                                            [input](int i) { return input[i]; });
+        }
+
+        delayDrySignal(numChannels, blockSize, latency);
+
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            const auto* delayed = dryBuffer.getReadPointer(channel);
+            outputLevels[static_cast<size_t>(channel)].write(channelData[channel] + offset, blockSize,
+                                                             [delayed](int i) { return delayed[i]; });
+        }
+    }
+
+    // Keep the parameter ramps where they would have been
+    if (isSmoothing())
+        advanceSmoothers(numSamples);
+    else
+        params = targetParameters;
+}
+
+template <typename SampleType>
+void DistortionEngine<SampleType>::delayDrySignal(int numChannels, int numSamples, int latency)
+{
+    const int ringSize = dryDelayBuffer.getNumSamples();
+    if (ringSize == 0)
+        return;
+
+    // Write the new dry block into the ring, then read back the block that
+    // was written 'latency' samples ago (which overlaps the new one when
+    // latency < numSamples)
+    const int writeStart = dryDelayWritePosition;
+    const int readStart = (writeStart - latency + ringSize) % ringSize;
+
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+        auto* ring = dryDelayBuffer.getWritePointer(channel);
+        auto* dry = dryBuffer.getWritePointer(channel);
+
+        const int firstWrite = juce::jmin(numSamples, ringSize - writeStart);
+        juce::FloatVectorOperations::copy(ring + writeStart, dry, firstWrite);
+        juce::FloatVectorOperations::copy(ring, dry + firstWrite, numSamples - firstWrite);
+
+        const int firstRead = juce::jmin(numSamples, ringSize - readStart);
+        juce::FloatVectorOperations::copy(dry, ring + readStart, firstRead);
+        juce::FloatVectorOperations::copy(dry + firstRead, ring, numSamples - firstRead);
+    }
+
+    dryDelayWritePosition = (writeStart + numSamples) % ringSize;
+}
+
+//==============================================================================
+template <typename SampleType>
+template <typename Shaper>
+void DistortionEngine<SampleType>::applyWaveshaper(const WaveshaperParameters& shaperParameters,
+                                                   AntialiasingState& state, SampleType* data, int numSamples)
+{
+    // Keep the ADAA history current so switching it on later starts cleanly
+    if (numSamples >= 2)
+    {
+        state.x2 = data[numSamples - 2];
+        state.x1 = data[numSamples - 1];
+    }
+    else if (numSamples == 1)
+    {
+        state.x2 = state.x1;
+        state.x1 = data[0];
+    }
+
+    // Stateless waveshaper pass. The functor is inlined, so this loop can be
+    // vectorized for every algorithm whose transfer function is branch-free.
+    if constexpr (! Shaper::isClean)
+    {
+        const Shaper shaper(shaperParameters);
+
+        for (int i = 0; i < numSamples; ++i)
+            data[i] = shaper(data[i]);
+    }
+    else
+    {
+        juce::ignoreUnused(shaperParameters);
+    }
+}
+
+template <typename SampleType>
+template <typename Shaper, int order>
+void DistortionEngine<SampleType>::applyAntialiasedWaveshaper(const WaveshaperParameters& shaperParameters,
+                                                              AntialiasingState& state, SampleType* data, int numSamples)
+{
+    constexpr int effectiveOrder = juce::jmin(order, Shaper::antialiasingOrder);
+
+    if constexpr (effectiveOrder == 0)
+    {
+        applyWaveshaper<Shaper>(shaperParameters, state, data, numSamples);
+    }
+    else
+    {
+        const Shaper shaper(shaperParameters);
+
+        if constexpr (effectiveOrder == 1)
+            ADAA::processFirstOrder(shaper, state, data, numSamples);
+        else
+            ADAA::processSecondOrder(shaper, state, data, numSamples);
+    }
+}
+
+template <typename SampleType>
+template <bool withDCBlocker, bool withSubOctave, typename DistortionEngine<SampleType>::ToneMode toneMode, int lanes>
+void DistortionEngine<SampleType>::applyFilters(int firstChannel, SampleType* const* channels, int numSamples)
+{
+    // Use independent amplitude so sub-octave is always audible
+    const auto subOctaveGain = static_cast<SampleType>(0.3f * params.subOctave);
+    const SampleType dcBlockerPole = coefficients.dcBlockerPole;
+    const SampleType subOctaveSmoothing = coefficients.subOctaveSmoothing;
+    const SampleType lowpassSmoothing = coefficients.toneLowpassSmoothing;
+    const SampleType highpassPole = coefficients.toneHighpassPole;
+    const SampleType toneBlend = coefficients.toneBlend;
+
+    // The recursion runs on local copies of each lane's state so it stays in
+    // registers
+    SampleType dcX1[lanes], dcY1[lanes];
+    SampleType subLastPositive[lanes], subSquare[lanes], subLowpassZ1[lanes];
+    SampleType lowpassZ1[lanes], highpassX1[lanes], highpassZ1[lanes];
+    SampleType x[lanes] = {};
+
+    for (int lane = 0; lane < lanes; ++lane)
+    {
+        const auto channel = static_cast<size_t>(firstChannel + lane);
+        dcX1[lane] = filterState.dcX1[channel];
+        dcY1[lane] = filterState.dcY1[channel];
+        subLastPositive[lane] = filterState.subLastPositive[channel];
+        subSquare[lane] = filterState.subSquare[channel];
+        subLowpassZ1[lane] = filterState.subLowpassZ1[channel];
+        lowpassZ1[lane] = filterState.toneLowpassZ1[channel];
+        highpassX1[lane] = filterState.toneHighpassX1[channel];
+        highpassZ1[lane] = filterState.toneHighpassZ1[channel];
+    }
+
+    // A single channel is filtered in place; several are interleaved so one
+    // frame holds every lane's sample
+    auto& levels = chunkOutputLevels[static_cast<size_t>(firstChannel)];
+    SampleType* frames = channels[0];
+    if constexpr (lanes > 1)
+    {
+        frames = interleavedScratch.data();
+        for (int lane = 0; lane < lanes; ++lane)
+            for (int i = 0; i < numSamples; ++i)
+                frames[i * lanes + lane] = channels[lane][i];
+    }
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        SampleType* frame = frames + i * lanes;
+
+        for (int lane = 0; lane < lanes; ++lane)
+        {
+            SampleType sample = frame[lane];
+
+            if constexpr (withDCBlocker)
+            {
+                // DC blocker: y[n] = x[n] - x[n-1] + pole * y[n-1]
+                dcY1[lane] = sample - dcX1[lane] + dcBlockerPole * dcY1[lane];
+                dcX1[lane] = sample;
+                sample = dcY1[lane];
+            }
+
+            if constexpr (withSubOctave)
+            {
+                // Flip the square wave on positive-going zero crossings; from
+                // rest (0) the first one starts it high
+                const SampleType currentPositive = sample > SampleType(0) ? SampleType(1) : SampleType(0);
+                const bool risingEdge = currentPositive > subLastPositive[lane];
+                const SampleType flipped = subSquare[lane] > SampleType(0) ? SampleType(-1) : SampleType(1);
+                subSquare[lane] = risingEdge ? flipped : subSquare[lane];
+                subLastPositive[lane] = currentPositive;
+
+                // Smooth the square wave
+                subLowpassZ1[lane] += subOctaveSmoothing * (subSquare[lane] - subLowpassZ1[lane]);
+                sample += subLowpassZ1[lane] * subOctaveGain;
+            }
+
+            x[lane] = sample;
+
+            if constexpr (toneMode == ToneMode::Dark)
+            {
+                // One-pole lowpass for dark tone
+                lowpassZ1[lane] += lowpassSmoothing * (sample - lowpassZ1[lane]);
+                frame[lane] = sample + (lowpassZ1[lane] - sample) * toneBlend;
+            }
+            else if constexpr (toneMode == ToneMode::Bright)
+            {
+                // Highpass for bright tone (using difference equation)
+                highpassZ1[lane] = sample - highpassX1[lane] + highpassPole * highpassZ1[lane];
+                highpassX1[lane] = sample;
+                frame[lane] = sample + (highpassZ1[lane] - sample) * toneBlend;
+            }
+            else
+            {
+                frame[lane] = sample;
+            }
+
+            if constexpr (lanes == 1)
+                levels.add(frame[lane]);
+        }
+    }
+
+    // Deinterleave, metering each channel as it is written back
+    if constexpr (lanes > 1)
+    {
+        for (int lane = 0; lane < lanes; ++lane)
+            chunkOutputLevels[static_cast<size_t>(firstChannel + lane)].write(channels[lane], numSamples,
+                [frames, lane](int i) { return frames[i * lanes + lane]; });
+    }
+
+    for (int lane = 0; lane < lanes; ++lane)
+    {
+        // A tone filter that was not needed for this block is primed with
+        // its steady state for the last input, so moving the knob off
+        // centre later does not start it from stale values
+        if (numSamples > 0)
+        {
+            if constexpr (toneMode != ToneMode::Dark)
+                lowpassZ1[lane] = x[lane];
+            if constexpr (toneMode != ToneMode::Bright)
+            {
+                highpassZ1[lane] = SampleType(0);
+                highpassX1[lane] = x[lane];
+            }
+        }
+
+        const auto channel = static_cast<size_t>(firstChannel + lane);
+        filterState.dcX1[channel] = dcX1[lane];
+        filterState.dcY1[channel] = dcY1[lane];
+        filterState.subLastPositive[channel] = subLastPositive[lane];
+        filterState.subSquare[channel] = subSquare[lane];
+        filterState.subLowpassZ1[channel] = subLowpassZ1[lane];
+        filterState.toneLowpassZ1[channel] = lowpassZ1[lane];
+        filterState.toneHighpassX1[channel] = highpassX1[lane];
+        filterState.toneHighpassZ1[channel] = highpassZ1[lane];
+    }
+}
+
+template <typename SampleType>
+void DistortionEngine<SampleType>::FilterState::resize(int numChannels)
+{
+    const auto size = static_cast<size_t>(juce::jmax(0, numChannels));
+    for (auto* values : { &dcX1, &dcY1, &subLastPositive, &subSquare, &subLowpassZ1,
+                          &toneLowpassZ1, &toneHighpassX1, &toneHighpassZ1 })
+        values->resize(size);
+
+    clear();
+}
+
+template <typename SampleType>
+void DistortionEngine<SampleType>::FilterState::clear()
+{
+    // The divided square wave starts at rest
+    for (auto* values : { &dcX1, &dcY1, &subLastPositive, &subSquare, &subLowpassZ1,
+                          &toneLowpassZ1, &toneHighpassX1, &toneHighpassZ1 })
+        std::fill(values->begin(), values->end(), SampleType(0));
+}
+
+//==============================================================================
+// Dispatch tables. Waveshapers get one row per accuracy tier and one row per
+// ADAA order, and one column per algorithm, plus the clean column used when
+// drive is at 1.0. The filter pass gets one set of lane widths per DC
+// blocker x sub-octave x tone combination.
+template <typename SampleType>
+struct DistortionEngine<SampleType>::KernelTable
+{
+    static constexpr int numToneModes = 3;
+    static constexpr int numShaperColumns = numDistortionTypes + 1;
+    static constexpr int cleanColumn = numDistortionTypes;
+
+    using ShaperRow = std::array<ShaperKernel, numShaperColumns>;
+
+    template <typename Math, size_t... shaperIndex>
+    static constexpr ShaperRow makeShaperRow(std::index_sequence<shaperIndex...>)
+    {
+        return { &DistortionEngine::template applyWaveshaper<std::tuple_element_t<shaperIndex, Waveshapers<Math, SampleType>>>...,
+                 &DistortionEngine::template applyWaveshaper<CleanWaveshaper<Math, SampleType>> };
+    }
+
+    template <typename Math>
+    static constexpr ShaperRow makeShaperRow()
+    {
+        return makeShaperRow<Math>(std::make_index_sequence<numDistortionTypes>());
+    }
+
+    template <int order, size_t... shaperIndex>
+    static constexpr ShaperRow makeAntialiasedRow(std::index_sequence<shaperIndex...>)
+    {
+        return { &DistortionEngine::template applyAntialiasedWaveshaper<std::tuple_element_t<shaperIndex, Waveshapers<ReferenceMath, SampleType>>, order>...,
+                 &DistortionEngine::template applyWaveshaper<CleanWaveshaper<ReferenceMath, SampleType>> };
+    }
+
+    template <int order>
+    static constexpr ShaperRow makeAntialiasedRow()
+    {
+        return makeAntialiasedRow<order>(std::make_index_sequence<numDistortionTypes>());
+    }
+
+    template <bool withDCBlocker, bool withSubOctave, ToneMode toneMode>
+    static constexpr FilterKernels makeFilterKernels()
+    {
+        return { &DistortionEngine::template applyFilters<withDCBlocker, withSubOctave, toneMode, 1>,
+                 &DistortionEngine::template applyFilters<withDCBlocker, withSubOctave, toneMode, 2>,
+                 &DistortionEngine::template applyFilters<withDCBlocker, withSubOctave, toneMode, maxFilterLanes> };
+    }
+
+    template <bool withDCBlocker>
+    static constexpr std::array<FilterKernels, 2 * numToneModes> makeFilterRow()
+    {
+        return { makeFilterKernels<withDCBlocker, false, ToneMode::Flat>(),
+                 makeFilterKernels<withDCBlocker, false, ToneMode::Dark>(),
+                 makeFilterKernels<withDCBlocker, false, ToneMode::Bright>(),
+                 makeFilterKernels<withDCBlocker, true, ToneMode::Flat>(),
+                 makeFilterKernels<withDCBlocker, true, ToneMode::Dark>(),
+                 makeFilterKernels<withDCBlocker, true, ToneMode::Bright>() };
+    }
+};
+
+template <typename SampleType>
+typename DistortionEngine<SampleType>::ShaperKernel DistortionEngine<SampleType>::selectShaperKernel() const
+{
+    // Indexed by MathPrecision
+    static constexpr std::array<typename KernelTable::ShaperRow, numMathPrecisions> kernels {
+        KernelTable::template makeShaperRow<ReferenceMath>(),
+        KernelTable::template makeShaperRow<AccurateMath>(),
+        KernelTable::template makeShaperRow<FastApproxMath>()
+    };
+
+    // Indexed by AntialiasingMode, starting at first order
+    static constexpr std::array<typename KernelTable::ShaperRow, numAntialiasingModes - 1> antialiasedKernels {
+        KernelTable::template makeAntialiasedRow<1>(),
+        KernelTable::template makeAntialiasedRow<2>()
+    };
+
+    const int antialiasing = juce::jlimit(0, numAntialiasingModes - 1, static_cast<int>(params.antialiasing));
+    const int row = juce::jlimit(0, numMathPrecisions - 1, static_cast<int>(params.precision));
+
+    // At drive=1.0: pass through unaffected
+    // Above drive=1.0: apply selected distortion algorithm
+    const int column = params.drive > 1.0f
+                     ? juce::jlimit(0, numDistortionTypes - 1, static_cast<int>(params.algorithm))
+                     : KernelTable::cleanColumn;
+
+    if (antialiasing > 0)
+        return antialiasedKernels[static_cast<size_t>(antialiasing - 1)][static_cast<size_t>(column)];
+
+    return kernels[static_cast<size_t>(row)][static_cast<size_t>(column)];
+}
+
+template <typename SampleType>
+const typename DistortionEngine<SampleType>::FilterKernels& DistortionEngine<SampleType>::selectFilterKernels() const
+{
+    // Indexed by whether the DC blocker runs
+    static constexpr std::array<std::array<FilterKernels, 2 * KernelTable::numToneModes>, 2> kernels {
+        KernelTable::template makeFilterRow<false>(),
+        KernelTable::template makeFilterRow<true>()
+    };
+
+    // The DC blocker only follows an actual waveshaper
+    const bool withDCBlocker = params.drive > 1.0f;
+
+    // Flat is exactly the centre of the knob; anywhere else needs a filter
+    const auto toneMode = params.tone < 0.5f ? ToneMode::Dark
+                        : params.tone > 0.5f ? ToneMode::Bright
+                                             : ToneMode::Flat;
+
+    const int column = (params.subOctave > 0.0f ? KernelTable::numToneModes : 0)
+                     + static_cast<int>(toneMode);
+
+    return kernels[withDCBlocker ? 1 : 0][static_cast<size_t>(column)];
+}
+
+//==============================================================================
+template class DistortionEngine<float>;
+template class DistortionEngine<double>;
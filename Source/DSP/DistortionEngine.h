@@ -0,0 +1,283 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <juce_dsp/juce_dsp.h>
+#include "DspProfiler.h"
+#include "LevelMeasurement.h"
+#include "Waveshapers.h"
+
+//==============================================================================
+// Filter design used by the oversampling stage. Linear phase uses JUCE's
+// equiripple FIR half-band stages, minimum phase its polyphase IIR allpass
+// stages, which have much less latency.
+enum class OversamplingPhase
+{
+    Linear = 0,
+    Minimum = 1
+};
+
+//==============================================================================
+// Plain parameter values, already converted from the APVTS ranges. Shared by
+// the float and double engines.
+struct DistortionParameters
+{
+    float drive = 1.0f;
+    float asymmetry = 0.0f;
+    float subOctave = 0.0f;
+    float dryWet = 1.0f;
+    float tone = 0.5f;
+    float foldDepth = 20.0f;
+    DistortionType algorithm = DistortionType::Tanh;
+    MathPrecision precision = MathPrecision::Accurate;
+    AntialiasingMode antialiasing = AntialiasingMode::Off;
+
+    // Oversampling around the waveshaper: 0 = 1x, 1 = 2x, 2 = 4x, 3 = 8x
+    int oversamplingOrder = 0;
+    OversamplingPhase oversamplingPhase = OversamplingPhase::Linear;
+
+    // Crossfades to the input delayed by the current latency, so toggling
+    // it neither clicks nor changes the latency the host compensates for
+    bool bypassed = false;
+};
+
+//==============================================================================
+// The complete drive -> DC blocker -> sub-octave -> tone -> mix chain.
+// This class knows nothing about juce::AudioProcessor, the APVTS or the
+// editor, so it can be driven from benchmarks and offline renders exactly the
+// same way processBlock drives it.
+//
+// SampleType is float or double; both are instantiated in
+// DistortionEngine.cpp, each with its own set of kernels.
+template <typename SampleType>
+class DistortionEngine
+{
+public:
+    using Parameters = DistortionParameters;
+
+    static constexpr int maxOversamplingOrder = 3;
+
+    DistortionEngine() = default;
+
+    //==============================================================================
+    void prepare(double sampleRate, int maximumBlockSize, int numChannels);
+    void reset();
+
+    // Continuous parameters ramp towards the new values (drive
+    // multiplicatively, the rest linearly) and bypass crossfades; the first
+    // call after reset() jumps straight to them. Switches take effect
+    // immediately.
+    void setParameters(const Parameters& newParameters);
+    const Parameters& getParameters() const { return targetParameters; }
+
+    // Delay added by the oversampling filters, in samples at the host rate.
+    // Valid for any setting once prepare() has been called.
+    int getLatencySamples() const;
+    int getLatencySamples(int oversamplingOrder, OversamplingPhase phase) const;
+
+    // How long the output keeps ringing once the input goes silent, for
+    // AudioProcessor::getTailLengthSeconds()
+    double getTailLengthSeconds() const;
+
+    // Processes the channels in place
+    void process(SampleType* const* channelData, int numChannels, int numSamples);
+    void process(juce::AudioBuffer<SampleType>& buffer);
+
+    // Peak and mean square of each channel over the last process() call, at
+    // the input and at the output. Taken by the copy into the dry buffer and
+    // by whichever stage writes the output last.
+    using Levels = LevelMeasurement<SampleType>;
+    const Levels& getInputLevels(int channel) const { return inputLevels[static_cast<size_t>(channel)]; }
+    const Levels& getOutputLevels(int channel) const { return outputLevels[static_cast<size_t>(channel)]; }
+
+    // Gain of the whole chain for a signal too quiet to saturate. How far
+    // the measured output falls short of input * this is the saturation.
+    double getSmallSignalGain() const;
+
+    // Which path the last process() call took, for load monitoring
+    enum class ProcessingState
+    {
+        Processing = 0,
+        Idle,      // Silent input into decayed state, output cleared
+        Bypassed   // Fully bypassed, only the dry delay ran
+    };
+    ProcessingState getProcessingState() const { return processingState; }
+
+#if OBLITERATOR_PROFILING
+    // Stage timings are recorded here while set
+    void setProfiler(DspProfiler* profilerToUse) { profiler = profilerToUse; }
+#endif
+
+private:
+    // The latest values from setParameters(), and the ones in effect for the
+    // chunk being processed
+    Parameters targetParameters;
+    Parameters params;
+
+    // Parameter ramps. While any of them moves, the buffer is processed in
+    // chunks of smoothingInterval samples with the parameters stepped per
+    // chunk and the dry/wet gain ramped per sample.
+    static constexpr double smoothingTimeSeconds = 0.02;
+    static constexpr int smoothingInterval = 32;
+    juce::SmoothedValue<float, juce::ValueSmoothingTypes::Multiplicative> driveSmoother;
+    juce::SmoothedValue<float> asymmetrySmoother, subOctaveSmoother, dryWetSmoother,
+                               toneSmoother, foldDepthSmoother;
+    bool snapToTargetParameters = true;
+    bool isSmoothing() const;
+    void advanceSmoothers(int numSamples);
+
+    // Bypass amount, 0 = processed and 1 = bypassed. Once fully bypassed
+    // only the dry delay runs, and the processing state restarts from
+    // silence when the fade back in begins.
+    static constexpr double bypassFadeSeconds = 0.01;
+    juce::SmoothedValue<SampleType> bypassGain;
+    bool isFullyBypassed() const;
+    void processBypassed(SampleType* const* channelData, int numChannels, int numSamples);
+    void resetProcessingState();
+
+    // Idle fast path. Once the input has been below silenceThreshold long
+    // enough to flush the dry delay and the oversampling filters, and the
+    // filter state that reaches the output has decayed below it too, blocks
+    // are cleared instead of processed.
+    static constexpr double silenceThreshold = 1.0e-6; // -120 dB
+    int silentSamples = 0;
+    ProcessingState processingState = ProcessingState::Processing;
+    bool isInputSilent(const SampleType* const* channelData, int numChannels, int numSamples) const;
+    bool hasDCBlockerDecayed(int numChannels) const;
+    bool hasStateDecayed(int numChannels) const;
+    static bool exceedsSilence(const std::vector<SampleType>& values, int numChannels);
+
+    // Largest block the scratch buffers can hold; longer host blocks are split
+    double currentSampleRate = 44100.0;
+    int maxBlockSize = 0;
+    int numPreparedChannels = 0;
+    juce::AudioBuffer<SampleType> dryBuffer;
+
+    // One oversampler per phase and factor (2x, 4x, 8x), all built in
+    // prepare() so switching never allocates on the audio thread
+    static constexpr int numOversamplingPhases = 2;
+    using Oversampler = juce::dsp::Oversampling<SampleType>;
+    std::unique_ptr<Oversampler> oversamplers[numOversamplingPhases][maxOversamplingOrder];
+    int oversamplerLatency[numOversamplingPhases][maxOversamplingOrder + 1] = {};
+    Oversampler* activeOversampler = nullptr;
+    Oversampler* getOversampler(int oversamplingOrder, OversamplingPhase phase) const;
+
+    // Delays the dry signal by the oversampling latency so the dry/wet mix
+    // stays phase aligned. One ring per channel, sharing the write position.
+    juce::AudioBuffer<SampleType> dryDelayBuffer;
+    int dryDelayWritePosition = 0;
+    void delayDrySignal(int numChannels, int numSamples, int latency);
+
+    // Wet gain per sample while the dry/wet mix or the bypass is ramping,
+    // both folded into one factor so the mix is a single pass
+    std::vector<SampleType> mixGain;
+
+    // Per channel, reset by every process() call. The filter kernels measure
+    // the chunk they write into chunkOutputLevels; the mix replaces that if
+    // it runs after them.
+    std::vector<Levels> inputLevels, outputLevels, chunkOutputLevels;
+
+    // Antiderivative anti-aliasing history (per channel)
+    std::vector<AntialiasingState> antialiasingState;
+
+    // Filter state for every channel, stored as one array per variable so
+    // neighbouring channels can be loaded into one SIMD register. Sized in
+    // prepare() for any channel count.
+    struct FilterState
+    {
+        // DC blocker
+        std::vector<SampleType> dcX1, dcY1;
+
+        // Octave divider: last input sign (0 or 1), the divided square wave
+        // (+1 or -1, 0 at rest after silence) and its smoothing lowpass
+        std::vector<SampleType> subLastPositive, subSquare, subLowpassZ1;
+
+        // Tone: one-pole lowpass for the dark side, one-pole highpass (last
+        // input and output) for the bright side
+        std::vector<SampleType> toneLowpassZ1, toneHighpassX1, toneHighpassZ1;
+
+        void resize(int numChannels);
+        void clear();
+    };
+    FilterState filterState;
+
+    // Channels filtered together per pass, and the scratch they are
+    // interleaved into while they run
+    static constexpr int maxFilterLanes = 4;
+    std::vector<SampleType> interleavedScratch;
+
+    //==============================================================================
+    // Filter corners in Hz. prepare() turns them into coefficients for the
+    // host rate, so a preset sounds the same at 44.1 kHz and 192 kHz; at
+    // 48 kHz they match the original fixed per-sample coefficients.
+    static constexpr double dcBlockerCutoffHz = 38.3;
+    static constexpr double subOctaveSmoothingHz = 805.0;
+    static constexpr double toneLowpassHz = 2725.0;
+    static constexpr double toneHighpassHz = 392.0;
+
+    struct FilterCoefficients
+    {
+        SampleType dcBlockerPole = SampleType(0.995);
+        SampleType subOctaveSmoothing = SampleType(0.1);
+        SampleType toneLowpassSmoothing = SampleType(0.3);
+        SampleType toneHighpassPole = SampleType(0.95);
+        SampleType toneBlend = 0;        // How far the tone knob is from centre
+        float tone = -1.0f;              // Tone value toneBlend was computed for
+    };
+    FilterCoefficients coefficients;
+    void updateFilterCoefficients(double sampleRate);
+    void updateToneCoefficients();
+
+    //==============================================================================
+    // Tone control: 0.0 = dark, 0.5 = flat, 1.0 = bright
+    enum class ToneMode
+    {
+        Flat = 0,
+        Dark,
+        Bright
+    };
+
+    // Inner loops are instantiated for every accuracy tier (or ADAA order) x
+    // waveshaper and for every DC blocker x sub-octave x tone combination.
+    // One of each is picked per block from a dispatch table, so the per-sample code never
+    // branches on a parameter.
+    using ShaperKernel = void (*)(const WaveshaperParameters& shaperParameters,
+                                  AntialiasingState& state, SampleType* data, int numSamples);
+    using FilterKernel = void (DistortionEngine::*)(int firstChannel, SampleType* const* channels, int numSamples);
+    struct KernelTable;
+    ShaperKernel selectShaperKernel() const;
+
+    // One filter kernel per lane count: 1, 2 and maxFilterLanes channels
+    static constexpr int numFilterLaneWidths = 3;
+    using FilterKernels = std::array<FilterKernel, numFilterLaneWidths>;
+    const FilterKernels& selectFilterKernels() const;
+
+    // Mixes with a wet gain ramping from dryWetStart to params.dryWet
+    void processChunk(const juce::dsp::AudioBlock<SampleType>& block,
+                      ShaperKernel shaperKernel, const FilterKernels& filterKernels,
+                      float dryWetStart);
+
+    // Waveshaper pass, run at the oversampled rate. The plain version is
+    // stateless apart from recording the ADAA history; the antialiased one
+    // uses the order clamped to what the Shaper supports.
+    template <typename Shaper>
+    static void applyWaveshaper(const WaveshaperParameters& shaperParameters,
+                                AntialiasingState& state, SampleType* data, int numSamples);
+
+    template <typename Shaper, int order>
+    static void applyAntialiasedWaveshaper(const WaveshaperParameters& shaperParameters,
+                                           AntialiasingState& state, SampleType* data, int numSamples);
+
+    // DC blocker, sub-octave and tone filter fused into one serial pass at
+    // the host rate, over 'lanes' channels at once starting at firstChannel.
+    // With more than one lane the channels are interleaved so each sample
+    // step advances all of them together.
+    template <bool withDCBlocker, bool withSubOctave, ToneMode toneMode, int lanes>
+    void applyFilters(int firstChannel, SampleType* const* channels, int numSamples);
+
+#if OBLITERATOR_PROFILING
+    DspProfiler* profiler = nullptr;
+#endif
+
+    //==============================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(DistortionEngine)
+};
@@ -0,0 +1,367 @@
+#pragma once
+
+// Stage timings for the processing chain, built only when
+// OBLITERATOR_PROFILING is 1 (Debug configurations, see CMakeLists.txt).
+// Otherwise the macros below expand to nothing and the class does not exist,
+// so release builds carry no trace of it.
+#ifndef OBLITERATOR_PROFILING
+ #define OBLITERATOR_PROFILING 0
+#endif
+
+#define OBLITERATOR_PROFILE_JOIN_INNER(a, b) a##b
+#define OBLITERATOR_PROFILE_JOIN(a, b) OBLITERATOR_PROFILE_JOIN_INNER(a, b)
+
+#if OBLITERATOR_PROFILING
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+// Times the rest of the enclosing scope as one stage. The profiler pointer
+// may be null.
+#define OBLITERATOR_PROFILE_STAGE(profilerPointer, stage) \
+    const DspProfiler::ScopedStage OBLITERATOR_PROFILE_JOIN(profiledStage, __LINE__) ((profilerPointer), (stage))
+
+// Times the rest of the enclosing scope as one host block of numSamples
+#define OBLITERATOR_PROFILE_BLOCK(profilerPointer, numSamples) \
+    const DspProfiler::ScopedBlock OBLITERATOR_PROFILE_JOIN(profiledBlock, __LINE__) ((profilerPointer), (numSamples))
+
+//==============================================================================
+// Per-instance timing histograms, worst-case block time against the host's
+// deadline, and a ring of recent stage events for Chrome trace export.
+//
+// The audio thread is the only writer. Every counter is a relaxed atomic
+// written without read-modify-write, and the trace ring is published with a
+// release store of its write position, so recording never locks or
+// allocates. The message thread reads whenever it likes; a reset is only
+// requested from there and carried out by the audio thread at the start of
+// its next block.
+class DspProfiler
+{
+public:
+    enum class Stage
+    {
+        Block = 0,   // The whole processBlock call
+        DryCopy,     // Input copy and dry delay
+        Waveshaper,  // Including oversampling up and down
+        Filters,     // DC blocker, sub-octave and tone, which run as one fused pass
+        Mix,         // Dry/wet and bypass crossfade
+        Analysis     // Scope, spectrum and meter publishing
+    };
+
+    static constexpr int numStages = 6;
+
+    static const char* getStageName(Stage stage)
+    {
+        static constexpr const char* names[numStages] { "Block", "Dry copy", "Waveshaper",
+                                                        "Filters", "Mix", "Analysis" };
+        return names[static_cast<int>(stage)];
+    }
+
+    // Histogram buckets a quarter octave wide, from 1 ns to about 67 ms
+    static constexpr int bucketsPerOctave = 4;
+    static constexpr int numOctaves = 26;
+    static constexpr int numBuckets = numOctaves * bucketsPerOctave;
+
+    static constexpr int traceSize = 1 << 13;
+
+    DspProfiler()
+        : traceEvents(std::make_unique<TraceEvent[]>(static_cast<size_t>(traceSize))),
+          epoch(std::chrono::steady_clock::now())
+    {
+    }
+
+    // Called while the audio thread is stopped
+    void prepare(double sampleRate, int samplesPerBlock)
+    {
+        currentSampleRate = sampleRate;
+        deadlineNs.store(1.0e9 * samplesPerBlock / sampleRate);
+        requestReset();
+    }
+
+    //==============================================================================
+    class ScopedStage
+    {
+    public:
+        ScopedStage(DspProfiler* profilerToUse, Stage stageToTime)
+            : profiler(profilerToUse), stage(stageToTime),
+              start(profiler != nullptr ? profiler->now() : 0)
+        {
+        }
+
+        ~ScopedStage()
+        {
+            if (profiler != nullptr)
+                profiler->record(stage, start, profiler->now());
+        }
+
+    private:
+        DspProfiler* profiler;
+        Stage stage;
+        uint64_t start;
+    };
+
+    class ScopedBlock
+    {
+    public:
+        ScopedBlock(DspProfiler* profilerToUse, int numSamplesInBlock)
+            : profiler(profilerToUse), numSamples(numSamplesInBlock)
+        {
+            if (profiler != nullptr)
+            {
+                profiler->applyPendingReset();
+                start = profiler->now();
+            }
+        }
+
+        ~ScopedBlock()
+        {
+            if (profiler != nullptr)
+                profiler->recordBlock(start, profiler->now(), numSamples);
+        }
+
+    private:
+        DspProfiler* profiler;
+        int numSamples;
+        uint64_t start = 0;
+    };
+
+    //==============================================================================
+    // Message thread
+    struct StageStatistics
+    {
+        uint64_t count = 0;
+        double meanNs = 0.0, p50Ns = 0.0, p99Ns = 0.0, maxNs = 0.0;
+    };
+
+    StageStatistics getStatistics(Stage stage) const
+    {
+        const auto& timings = stages[static_cast<size_t>(stage)];
+        std::array<uint32_t, numBuckets> counts {};
+        uint64_t total = 0;
+        for (size_t bucket = 0; bucket < counts.size(); ++bucket)
+            total += counts[bucket] = timings.histogram[bucket].load(std::memory_order_relaxed);
+
+        StageStatistics result;
+        result.count = total;
+        if (total == 0)
+            return result;
+
+        result.meanNs = static_cast<double>(timings.totalNs.load(std::memory_order_relaxed))
+                      / static_cast<double>(std::max<uint64_t>(1, timings.count.load(std::memory_order_relaxed)));
+        result.maxNs = static_cast<double>(timings.maxNs.load(std::memory_order_relaxed));
+
+        // Upper edge of the bucket holding the percentile
+        const auto percentile = [&](double fraction)
+        {
+            const auto rank = static_cast<uint64_t>(std::ceil(fraction * static_cast<double>(total)));
+            uint64_t seen = 0;
+            for (int bucket = 0; bucket < numBuckets; ++bucket)
+            {
+                seen += counts[static_cast<size_t>(bucket)];
+                if (seen >= rank)
+                    return std::min(getBucketStart(bucket + 1), result.maxNs);
+            }
+            return result.maxNs;
+        };
+
+        result.p50Ns = percentile(0.5);
+        result.p99Ns = percentile(0.99);
+        return result;
+    }
+
+    struct BlockStatistics
+    {
+        double deadlineNs = 0.0;  // samplesPerBlock / sampleRate from prepare()
+        double worstNs = 0.0;     // Longest block
+        double worstLoad = 0.0;   // Highest time / duration of any block
+        uint64_t overruns = 0;    // Blocks that took longer than the deadline
+        uint64_t blocks = 0;
+    };
+
+    BlockStatistics getBlockStatistics() const
+    {
+        BlockStatistics result;
+        result.deadlineNs = deadlineNs.load(std::memory_order_relaxed);
+        result.worstNs = static_cast<double>(stages[0].maxNs.load(std::memory_order_relaxed));
+        result.worstLoad = worstLoad.load(std::memory_order_relaxed);
+        result.overruns = overruns.load(std::memory_order_relaxed);
+        result.blocks = stages[0].count.load(std::memory_order_relaxed);
+        return result;
+    }
+
+    // The recent events as Chrome trace JSON (chrome://tracing, Perfetto)
+    std::string createChromeTrace() const
+    {
+        const uint64_t end = tracePosition.load(std::memory_order_acquire);
+        const uint64_t begin = end > static_cast<uint64_t>(traceSize) ? end - static_cast<uint64_t>(traceSize) : 0;
+
+        // Read everything first, then drop whatever the writer may have
+        // overwritten meanwhile
+        auto copy = std::make_unique<TraceEvent::Value[]>(static_cast<size_t>(end - begin));
+        for (uint64_t position = begin; position < end; ++position)
+            copy[static_cast<size_t>(position - begin)] = traceEvents[static_cast<size_t>(position % traceSize)].load();
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        const uint64_t writtenSince = tracePosition.load(std::memory_order_relaxed);
+        const uint64_t firstIntact = writtenSince >= static_cast<uint64_t>(traceSize) ? writtenSince - static_cast<uint64_t>(traceSize) + 1 : 0;
+
+        std::string json = "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+        bool first = true;
+
+        for (uint64_t position = std::max(begin, firstIntact); position < end; ++position)
+        {
+            const auto& event = copy[static_cast<size_t>(position - begin)];
+            json += first ? "" : ",";
+            first = false;
+            json += "{\"name\":\"";
+            json += getStageName(event.stage);
+            json += "\",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":" + std::to_string(static_cast<double>(event.startNs) * 0.001)
+                  + ",\"dur\":" + std::to_string(static_cast<double>(event.durationNs) * 0.001) + "}";
+        }
+
+        return json + "]}";
+    }
+
+    void requestReset() { resetRequested.store(true); }
+
+private:
+    //==============================================================================
+    struct StageTimings
+    {
+        std::array<std::atomic<uint32_t>, numBuckets> histogram {};
+        std::atomic<uint64_t> count { 0 }, totalNs { 0 }, maxNs { 0 };
+    };
+
+    // One stage event, packed into two words so each half is a plain atomic
+    struct TraceEvent
+    {
+        struct Value
+        {
+            uint64_t startNs = 0;
+            uint32_t durationNs = 0;
+            Stage stage = Stage::Block;
+        };
+
+        std::atomic<uint64_t> start { 0 };
+        std::atomic<uint64_t> info { 0 }; // Duration << 8 | stage
+
+        void store(const Value& value)
+        {
+            start.store(value.startNs, std::memory_order_relaxed);
+            info.store(static_cast<uint64_t>(value.durationNs) << 8 | static_cast<uint64_t>(value.stage), std::memory_order_relaxed);
+        }
+
+        Value load() const
+        {
+            const auto packed = info.load(std::memory_order_relaxed);
+            return { start.load(std::memory_order_relaxed), static_cast<uint32_t>(packed >> 8), static_cast<Stage>(packed & 0xff) };
+        }
+    };
+
+    uint64_t now() const
+    {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - epoch).count());
+    }
+
+    static int getBucket(uint64_t ns)
+    {
+        if (ns == 0)
+            return 0;
+
+        int octave = 0;
+        while ((ns >> octave) > 1)
+            ++octave;
+
+        // The two bits below the leading one pick the quarter octave
+        const int fraction = octave >= 2 ? static_cast<int>((ns >> (octave - 2)) & 3)
+                                         : static_cast<int>((ns << (2 - octave)) & 3);
+        return std::min(numBuckets - 1, octave * bucketsPerOctave + fraction);
+    }
+
+    static double getBucketStart(int bucket)
+    {
+        return std::ldexp(1.0 + (bucket % bucketsPerOctave) / static_cast<double>(bucketsPerOctave),
+                          bucket / bucketsPerOctave);
+    }
+
+    // Single writer, so plain load + store instead of read-modify-write
+    template <typename Type>
+    static void increment(std::atomic<Type>& value, Type amount = 1)
+    {
+        value.store(value.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+    }
+
+    void record(Stage stage, uint64_t startNs, uint64_t endNs)
+    {
+        const uint64_t duration = endNs - startNs;
+        auto& timings = stages[static_cast<size_t>(stage)];
+        increment(timings.histogram[static_cast<size_t>(getBucket(duration))], 1u);
+        increment(timings.count, static_cast<uint64_t>(1));
+        increment(timings.totalNs, duration);
+        if (duration > timings.maxNs.load(std::memory_order_relaxed))
+            timings.maxNs.store(duration, std::memory_order_relaxed);
+
+        const uint64_t position = tracePosition.load(std::memory_order_relaxed);
+        traceEvents[static_cast<size_t>(position % traceSize)].store(
+                { startNs, static_cast<uint32_t>(std::min<uint64_t>(duration, 0xffffffffu)), stage });
+        tracePosition.store(position + 1, std::memory_order_release);
+    }
+
+    void recordBlock(uint64_t startNs, uint64_t endNs, int numSamples)
+    {
+        record(Stage::Block, startNs, endNs);
+
+        const auto duration = static_cast<double>(endNs - startNs);
+        if (duration > deadlineNs.load(std::memory_order_relaxed))
+            increment(overruns, static_cast<uint64_t>(1));
+
+        if (numSamples > 0)
+        {
+            const double load = duration * currentSampleRate / (1.0e9 * numSamples);
+            if (load > worstLoad.load(std::memory_order_relaxed))
+                worstLoad.store(load, std::memory_order_relaxed);
+        }
+    }
+
+    void applyPendingReset()
+    {
+        if (! resetRequested.exchange(false))
+            return;
+
+        for (auto& timings : stages)
+        {
+            for (auto& bucket : timings.histogram)
+                bucket.store(0, std::memory_order_relaxed);
+            timings.count.store(0, std::memory_order_relaxed);
+            timings.totalNs.store(0, std::memory_order_relaxed);
+            timings.maxNs.store(0, std::memory_order_relaxed);
+        }
+
+        worstLoad.store(0.0, std::memory_order_relaxed);
+        overruns.store(0, std::memory_order_relaxed);
+    }
+
+    std::array<StageTimings, numStages> stages;
+    std::atomic<double> deadlineNs { 0.0 }, worstLoad { 0.0 };
+    std::atomic<uint64_t> overruns { 0 };
+    std::atomic<bool> resetRequested { false };
+    double currentSampleRate = 44100.0;
+
+    std::unique_ptr<TraceEvent[]> traceEvents;
+    std::atomic<uint64_t> tracePosition { 0 };
+    const std::chrono::steady_clock::time_point epoch;
+};
+
+#else
+
+#define OBLITERATOR_PROFILE_STAGE(profilerPointer, stage)
+#define OBLITERATOR_PROFILE_BLOCK(profilerPointer, numSamples)
+
+#endif
@@ -0,0 +1,157 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+//==============================================================================
+// Branch-free approximations of the libm functions used by the waveshapers.
+// They are built from arithmetic, min/max and bit casts only, so the
+// waveshaper loops stay vectorizable. No lookup tables are involved, so there
+// is nothing to allocate or share between plugin instances.
+namespace FastMath
+{
+    // Layout of the IEEE formats the bit tricks below rely on
+    template <typename T> struct FloatBits;
+
+    template <> struct FloatBits<float>
+    {
+        using Integer = int32_t;
+        static constexpr int mantissaBits = 23;
+        static constexpr int exponentBias = 127;
+    };
+
+    template <> struct FloatBits<double>
+    {
+        using Integer = int64_t;
+        static constexpr int mantissaBits = 52;
+        static constexpr int exponentBias = 1023;
+    };
+
+    // 2^x, computed as 2^round(x) written straight into the exponent bits
+    // times a polynomial for the remaining fraction in [-0.5, 0.5]. The
+    // constant term is exactly 1, so 2^0 = 1.
+    //   degree 12: Taylor series, max relative error 3.9e-16 (double only)
+    //   degree 5:  minimax relative fit, max relative error 1.8e-7
+    //   degree 3:  minimax relative fit, max relative error 1.0e-4
+    // Inputs are clamped to the normal exponent range of T.
+    template <int degree, typename T>
+    inline T exp2(T x)
+    {
+        static_assert(degree == 3 || degree == 5 || degree == 12, "Only the degree 3, 5 and 12 fits are tabulated");
+        static_assert(degree != 12 || sizeof(T) == sizeof(double), "The degree 12 fit is only worth it in double");
+        using Bits = FloatBits<T>;
+        using Integer = typename Bits::Integer;
+
+        constexpr T maxExponent = static_cast<T>(Bits::exponentBias - 1);
+        x = std::min(std::max(x, -maxExponent), maxExponent);
+
+        // Round to nearest by pushing the fraction out of the mantissa
+        constexpr T roundingMagic = static_cast<T>(1.5) * static_cast<T>(Integer(1) << Bits::mantissaBits);
+        const T n = (x + roundingMagic) - roundingMagic;
+        const T f = x - n;
+
+        T p;
+        if constexpr (degree == 12)
+        {
+            constexpr T c[] = { 1.0, 0.69314718055994529, 0.24022650695910069, 0.055504108664821576,
+                                0.0096181291076284769, 0.0013333558146428441, 0.00015403530393381606,
+                                1.5252733804059838e-05, 1.3215486790144305e-06, 1.0178086009239696e-07,
+                                7.0549116208011209e-09, 4.4455382718708101e-10, 2.5678435993488196e-11 };
+            p = c[12];
+            for (int k = 11; k >= 0; --k)
+                p = c[k] + f * p;
+        }
+        else if constexpr (degree == 5)
+        {
+            constexpr T c[] = { 0.693147063f, 0.240222111f, 0.0555065460f,
+                                0.00967295188f, 0.00132877775f };
+            p = T(1) + f * (c[0] + f * (c[1] + f * (c[2] + f * (c[3] + f * c[4]))));
+        }
+        else
+        {
+            constexpr T c[] = { 0.693282723f, 0.242211044f, 0.0550097041f };
+            p = T(1) + f * (c[0] + f * (c[1] + f * c[2]));
+        }
+
+        const Integer bits = (static_cast<Integer>(n) + Bits::exponentBias) * (Integer(1) << Bits::mantissaBits);
+        T scale;
+        std::memcpy(&scale, &bits, sizeof(scale));
+        return p * scale;
+    }
+
+    // The fit that keeps each type's error at the level of its own rounding
+    template <typename T>
+    constexpr int accurateDegree = sizeof(T) == sizeof(double) ? 12 : 5;
+
+    // e^x on top of exp2. Rounding x * log2(e) adds to the error for large
+    // arguments: degree 5 stays below 6.3e-7 relative for |x| < 10 and
+    // 4.0e-6 up to the exponent clamp at |x| = 87.3, degree 3 below 1.1e-4,
+    // degree 12 below 1e-13 across the double range.
+    template <int degree, typename T>
+    inline T exp(T x)
+    {
+        constexpr T log2e = static_cast<T>(1.4426950408889634);
+        return exp2<degree>(x * log2e);
+    }
+
+    // tanh(x) = (e^2x - 1) / (e^2x + 1) on the accurate exp for T.
+    // Max absolute error 1.4e-7 in float, 4e-16 in double.
+    template <typename T>
+    inline T tanhAccurate(T x)
+    {
+        // Past these, tanh is 1 to within the precision of T
+        constexpr T limit = sizeof(T) == sizeof(double) ? T(19.5) : T(9);
+        const T magnitude = std::min(std::abs(x), limit);
+
+        // Evaluated on |x| with the sign put back, so the result is exactly
+        // odd and silence stays at zero
+        constexpr T twoLog2e = static_cast<T>(2.8853900817779268);
+        const T e = exp2<accurateDegree<T>>(magnitude * twoLog2e);
+        return std::copysign((e - T(1)) / (e + T(1)), x);
+    }
+
+    // [7/6] Pade approximant of tanh, clamped where it reaches +-1.
+    // Max absolute error 9.6e-5 over the whole range.
+    template <typename T>
+    inline T tanhFast(T x)
+    {
+        constexpr T limit = static_cast<T>(4.97);
+        x = std::min(std::max(x, -limit), limit);
+
+        const T x2 = x * x;
+        return x * (T(135135) + x2 * (T(17325) + x2 * (T(378) + x2)))
+                 / (T(135135) + x2 * (T(62370) + x2 * (T(3150) + x2 * T(28))));
+    }
+}
+
+//==============================================================================
+// Accuracy tiers for the waveshaper transcendentals. The waveshapers take one
+// of the policies below as a template argument, for float or double samples.
+enum class MathPrecision
+{
+    Reference = 0, // Standard library, kept as the reference implementation
+    Accurate = 1,  // Error at the level of the sample type's rounding
+    Fast = 2       // Error around 1e-4 (-80 dB), inaudible under distortion
+};
+
+constexpr int numMathPrecisions = 3;
+
+struct ReferenceMath
+{
+    template <typename T> static T tanh(T x) { return std::tanh(x); }
+    template <typename T> static T exp(T x) { return std::exp(x); }
+};
+
+struct AccurateMath
+{
+    template <typename T> static T tanh(T x) { return FastMath::tanhAccurate(x); }
+    template <typename T> static T exp(T x) { return FastMath::exp<FastMath::accurateDegree<T>>(x); }
+};
+
+struct FastApproxMath
+{
+    template <typename T> static T tanh(T x) { return FastMath::tanhFast(x); }
+    template <typename T> static T exp(T x) { return FastMath::exp<3>(x); }
+};
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+
+//==============================================================================
+// Peak and sum of squares of one channel, gathered by the loops that write
+// the signal anyway, so metering never needs a pass of its own.
+//
+// write() keeps numLanes independent partial results and folds them at the
+// end, which lets the compiler turn both reductions into SIMD max and add
+// across a register; add() is for serial loops that produce one sample at a
+// time. Not thread safe: the owner publishes the results.
+template <typename SampleType>
+struct LevelMeasurement
+{
+    static constexpr int numLanes = 8;
+
+    SampleType peak = 0;
+    SampleType sumOfSquares = 0;
+    int numSamples = 0;
+
+    void clear() { *this = {}; }
+
+    SampleType getMeanSquare() const
+    {
+        return numSamples > 0 ? sumOfSquares / static_cast<SampleType>(numSamples) : SampleType(0);
+    }
+
+    void add(SampleType sample)
+    {
+        peak = std::max(peak, std::abs(sample));
+        sumOfSquares += sample * sample;
+        ++numSamples;
+    }
+
+    void merge(const LevelMeasurement& other)
+    {
+        peak = std::max(peak, other.peak);
+        sumOfSquares += other.sumOfSquares;
+        numSamples += other.numSamples;
+    }
+
+    // output[i] = generate(i) for every sample, measuring what is written.
+    // generate may read output[i] itself, for in-place stages.
+    template <typename Generator>
+    void write(SampleType* output, int count, Generator&& generate)
+    {
+        SampleType lanePeak[numLanes] = {};
+        SampleType laneSum[numLanes] = {};
+
+        int i = 0;
+        for (; i + numLanes <= count; i += numLanes)
+        {
+            for (int lane = 0; lane < numLanes; ++lane)
+            {
+                const SampleType sample = generate(i + lane);
+                output[i + lane] = sample;
+                lanePeak[lane] = std::max(lanePeak[lane], std::abs(sample));
+                laneSum[lane] += sample * sample;
+            }
+        }
+
+        for (; i < count; ++i)
+        {
+            const SampleType sample = generate(i);
+            output[i] = sample;
+            lanePeak[0] = std::max(lanePeak[0], std::abs(sample));
+            laneSum[0] += sample * sample;
+        }
+
+        for (int lane = 0; lane < numLanes; ++lane)
+        {
+            peak = std::max(peak, lanePeak[lane]);
+            sumOfSquares += laneSum[lane];
+        }
+
+        numSamples += count;
+    }
+};
@@ -0,0 +1,251 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <tuple>
+#include "AntiderivativeAntialiasing.h"
+#include "FastMath.h"
+
+//==============================================================================
+// Distortion algorithm types
+enum class DistortionType
+{
+    Tanh = 0,
+    Foldback = 1,
+    Tube = 2
+};
+
+//==============================================================================
+// The subset of the engine parameters that shapes the transfer function
+struct WaveshaperParameters
+{
+    float drive = 1.0f;
+    float asymmetry = 0.0f;
+    float foldDepth = 20.0f; // Maximum number of reflections (Foldback only)
+};
+
+//==============================================================================
+// Waveshaper functors. Each one is constructed once per block from the
+// current WaveshaperParameters, so anything that only depends on the parameters
+// (bias, gain, sqrt(drive), thresholds) is computed there. operator() is the
+// per-sample transfer function, and DistortionEngine instantiates its inner
+// loop for every functor so the call is inlined.
+//
+// The Math argument selects the accuracy tier of tanh/exp (see FastMath.h),
+// and SampleType is float or double; the constants are held in SampleType.
+//
+// isClean marks the pass-through used at drive 1.0 (the engine skips the
+// waveshaper pass entirely), and blocksDC tells the engine whether the
+// output needs the DC blocker.
+//
+// antialiasingOrder is the highest ADAA order the functor supports, with the
+// hooks described in AntiderivativeAntialiasing.h. The antiderivatives always
+// use the standard library in double precision, whatever the Math tier.
+template <typename Math, typename SampleType>
+struct CleanWaveshaper
+{
+    static constexpr bool isClean = true;
+    static constexpr bool blocksDC = false;
+    static constexpr int antialiasingOrder = 0;
+
+    explicit CleanWaveshaper(const WaveshaperParameters&) {}
+    SampleType operator()(SampleType input) const { return input; }
+};
+
+template <typename Math, typename SampleType>
+struct TanhWaveshaper
+{
+    static constexpr bool isClean = false;
+    static constexpr bool blocksDC = true;
+
+    explicit TanhWaveshaper(const WaveshaperParameters& p)
+        : gain(static_cast<SampleType>(p.drive)),
+          bias(static_cast<SampleType>(p.asymmetry) * SampleType(0.5)) // Apply asymmetric bias before distortion
+    {
+    }
+
+    SampleType operator()(SampleType input) const
+    {
+        return Math::tanh(gain * (input + bias));
+    }
+
+    // ADAA hooks, with u = drive * (input + bias)
+    static constexpr int antialiasingOrder = 2;
+    static constexpr double outputGain = 1.0;
+
+    double toShaperDomain(double input) const { return (input + bias) * gain; }
+    double transfer(double u) const { return std::tanh(u); }
+
+    // ln(cosh(u)), written so it cannot overflow
+    double antiderivative1(double u) const
+    {
+        const double a = std::abs(u);
+        return a + std::log1p(std::exp(-2.0 * a)) - 0.69314718055994531;
+    }
+
+    // Integral of ln(cosh(u)) from 0, which is odd in u:
+    // u^2/2 - u ln2 + Li2(-e^-2u)/2 + pi^2/24 for u >= 0
+    double antiderivative2(double u) const
+    {
+        const double a = std::abs(u);
+        const double value = 0.5 * a * a - 0.69314718055994531 * a
+                           + 0.5 * ADAA::dilogarithmOfNegative(std::exp(-2.0 * a))
+                           + 0.41123351671205660; // pi^2 / 24
+        return u < 0.0 ? -value : value;
+    }
+
+    SampleType gain, bias;
+};
+
+template <typename Math, typename SampleType>
+struct FoldbackWaveshaper
+{
+    static constexpr bool isClean = false;
+    static constexpr bool blocksDC = true;
+
+    // Asymmetric folding: adjust thresholds based on asymmetry parameter
+    // Positive asymmetry = higher positive threshold, lower negative threshold
+    // Negative asymmetry = lower positive threshold, higher negative threshold
+    explicit FoldbackWaveshaper(const WaveshaperParameters& p)
+        : gain(std::sqrt(static_cast<SampleType>(p.drive))), // Scale input by drive amount (use moderate scaling)
+          lower(-(SampleType(1) - static_cast<SampleType>(p.asymmetry) * SampleType(0.5))),
+          width((SampleType(1) + static_cast<SampleType>(p.asymmetry) * SampleType(0.5)) - lower)
+    {
+        // Repeatedly reflecting at the two thresholds is a triangle wave
+        // with a period of twice the fold width, evaluated in closed form.
+        // Limiting the input to foldDepth widths beyond either threshold
+        // caps the number of reflections, and the offset (a whole number of
+        // periods) keeps the phase positive so truncation acts as floor().
+        const SampleType depth = std::max(SampleType(0), static_cast<SampleType>(p.foldDepth));
+        period = SampleType(2) * width;
+        inversePeriod = SampleType(1) / period;
+        minInput = lower - depth * width;
+        maxInput = lower + width + depth * width;
+        phaseOffset = period * (std::ceil(depth * SampleType(0.5)) + SampleType(1)) - lower;
+    }
+
+    SampleType operator()(SampleType input) const
+    {
+        // Apply asymmetric wave folding with reflection. Same cost at any
+        // drive, and no data-dependent branches.
+        const SampleType x = std::min(std::max(input * gain, minInput), maxInput);
+        SampleType phase = x + phaseOffset;
+        phase -= period * static_cast<SampleType>(static_cast<int>(phase * inversePeriod));
+        const SampleType foldedSample = lower + width - std::abs(phase - width);
+
+        // Simple output scaling to maintain reasonable levels
+        return foldedSample * static_cast<SampleType>(outputGain);
+    }
+
+    // ADAA hooks, with u = sqrt(drive) * input. The fold is piecewise linear,
+    // so its antiderivative is piecewise quadratic and first order is exact
+    // and cheap; second order requests fall back to first order.
+    static constexpr int antialiasingOrder = 1;
+    static constexpr double outputGain = 0.8;
+
+    double toShaperDomain(double input) const { return input * gain; }
+
+    double transfer(double u) const
+    {
+        const double x = std::min(std::max(u, static_cast<double>(minInput)), static_cast<double>(maxInput));
+        const double phase = foldPhase(x);
+        return lower + width - std::abs(phase - width);
+    }
+
+    double antiderivative1(double u) const
+    {
+        // Outside the fold depth the output is held, so F1 continues linearly
+        const double clampedU = std::min(std::max(u, static_cast<double>(minInput)), static_cast<double>(maxInput));
+        return foldIntegral(clampedU) + transfer(clampedU) * (u - clampedU);
+    }
+
+    SampleType gain, lower, width;
+    SampleType period = 0, inversePeriod = 0;
+    SampleType minInput = 0, maxInput = 0, phaseOffset = 0;
+
+private:
+    double foldPhase(double x) const
+    {
+        const double phase = x + phaseOffset;
+        return phase - period * std::floor(phase / period);
+    }
+
+    // Integral of the fold from the start of the phase range: every whole
+    // period contributes width^2 (on top of the lower threshold), and within
+    // a period the triangle integrates to a parabola on each slope
+    double foldIntegral(double x) const
+    {
+        const double w = width;
+        const double phase = x + phaseOffset;
+        const double periods = std::floor(phase / period);
+        const double t = phase - periods * period;
+        const double withinPeriod = t <= w ? 0.5 * t * t
+                                           : w * w - 0.5 * (2.0 * w - t) * (2.0 * w - t);
+
+        return lower * x + periods * w * w + withinPeriod;
+    }
+};
+
+template <typename Math, typename SampleType>
+struct TubeWaveshaper
+{
+    static constexpr bool isClean = false;
+    static constexpr bool blocksDC = true;
+
+    // Scale input by drive amount with high sensitivity for extreme saturation
+    // Use sqrt to match the intensity curve, with aggressive multiplier
+    explicit TubeWaveshaper(const WaveshaperParameters& p)
+        : gain(std::sqrt(static_cast<SampleType>(p.drive)) * SampleType(5)),
+          bias(static_cast<SampleType>(p.asymmetry) * SampleType(0.5)) // Apply asymmetric bias before distortion
+    {
+    }
+
+    SampleType operator()(SampleType input) const
+    {
+        // Tube distortion using exponential saturation
+        // Positive side: softer compression, 1 - e^-x
+        // Negative side: slightly harder compression (tube characteristic), e^1.2x - 1
+        const SampleType x = (input + bias) * gain;
+        const bool positive = x >= SampleType(0);
+        const SampleType e = Math::exp(positive ? -x : x * SampleType(1.2));
+
+        // Apply gentle compression to tame peaks
+        return (positive ? SampleType(1) - e : e - SampleType(1)) * static_cast<SampleType>(outputGain);
+    }
+
+    // ADAA hooks, with u = (input + bias) * gain. Integration constants are
+    // picked so both antiderivatives are continuous at u = 0.
+    static constexpr int antialiasingOrder = 2;
+    static constexpr double outputGain = 0.85;
+
+    double toShaperDomain(double input) const { return (input + bias) * gain; }
+
+    double transfer(double u) const
+    {
+        return u >= 0.0 ? 1.0 - std::exp(-u) : std::exp(1.2 * u) - 1.0;
+    }
+
+    double antiderivative1(double u) const
+    {
+        return u >= 0.0 ? u + std::exp(-u) - 1.0
+                        : std::exp(1.2 * u) / 1.2 - u - 1.0 / 1.2;
+    }
+
+    double antiderivative2(double u) const
+    {
+        return u >= 0.0 ? 0.5 * u * u - u - std::exp(-u) + 1.0
+                        : std::exp(1.2 * u) / 1.44 - 0.5 * u * u - u / 1.2 - 1.0 / 1.44;
+    }
+
+    SampleType gain, bias;
+};
+
+//==============================================================================
+// One entry per DistortionType, in enum order. Adding an algorithm means
+// adding its enum value, its functor and its entry here.
+template <typename Math, typename SampleType>
+using Waveshapers = std::tuple<TanhWaveshaper<Math, SampleType>,
+                               FoldbackWaveshaper<Math, SampleType>,
+                               TubeWaveshaper<Math, SampleType>>;
+
+constexpr int numDistortionTypes = static_cast<int>(std::tuple_size_v<Waveshapers<ReferenceMath, float>>);
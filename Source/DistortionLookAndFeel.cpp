@@ -1,18 +1,30 @@
 #include "DistortionLookAndFeel.h"
-#include "BinaryData.h"
 
 DistortionLookAndFeel::DistortionLookAndFeel()
 {
-    // Load the knob SVG from binary data
-    knobSVG = juce::Drawable::createFromImageData(
-        BinaryData::knob1_svg, BinaryData::knob1_svgSize);
+    knobSprites->addChangeListener(this);
+}
+
+DistortionLookAndFeel::~DistortionLookAndFeel()
+{
+    knobSprites->removeChangeListener(this);
+}
+
+void DistortionLookAndFeel::changeListenerCallback(juce::ChangeBroadcaster*)
+{
+    for (auto& slider : slidersAwaitingSprites)
+        if (slider != nullptr)
+            slider->repaint();
+
+    slidersAwaitingSprites.clear();
 }
 
 void DistortionLookAndFeel::drawRotarySlider(juce::Graphics& g, int x, int y, int width, int height,
                                            float sliderPos, float rotaryStartAngle, float rotaryEndAngle,
                                            juce::Slider& slider)
 {
-    if (!knobSVG)
+    const auto* knobSVG = knobSprites->getKnobDrawable();
+    if (knobSVG == nullptr)
     {
         // Fallback to default slider if SVG fails to load
         juce::LookAndFeel_V4::drawRotarySlider(g, x, y, width, height, sliderPos,
@@ -20,9 +32,6 @@ void DistortionLookAndFeel::drawRotarySlider(juce::Graphics& g, int x, int y, in
         return;
     }
 
-    // Calculate the rotation angle based on slider position
-    auto currentAngle = rotaryStartAngle + (sliderPos * (rotaryEndAngle - rotaryStartAngle));
-
     // Determine knob size based on parameter range (drive has range 1-1000)
     bool isDriveKnob = (slider.getMaximum() > 100.0);
     float knobSize = isDriveKnob ? 95.0f : 54.0f;  // Knob itself
@@ -33,26 +42,67 @@ void DistortionLookAndFeel::drawRotarySlider(juce::Graphics& g, int x, int y, in
     auto knobBounds = juce::Rectangle<float>(knobSize, knobSize)
                         .withCentre(fullBounds.getCentre());
 
-    // Calculate center point for rotation
-    auto centerX = knobBounds.getCentreX();
-    auto centerY = knobBounds.getCentreY();
+    // One blit from the shared sprite sheet for this size and display scale
+    const float scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+    if (const auto* sheet = knobSprites->getSheet(knobSize, scale, rotaryStartAngle, rotaryEndAngle))
+    {
+        const auto frame = sheet->getFrameArea(KnobSpriteCache::getFrameIndex(sliderPos));
+        g.drawImage(sheet->image,
+                    juce::roundToInt(knobBounds.getX()), juce::roundToInt(knobBounds.getY()),
+                    juce::roundToInt(knobSize), juce::roundToInt(knobSize),
+                    frame.getX(), frame.getY(), frame.getWidth(), frame.getHeight());
+    }
+    else
+    {
+        // Sheet still being built: rotate and draw the SVG directly, and
+        // repaint once the sheet is ready
+        if (std::find(slidersAwaitingSprites.begin(), slidersAwaitingSprites.end(), &slider)
+                == slidersAwaitingSprites.end())
+            slidersAwaitingSprites.emplace_back(&slider);
+
+        auto currentAngle = rotaryStartAngle + (sliderPos * (rotaryEndAngle - rotaryStartAngle));
+        auto transform = juce::AffineTransform::rotation(currentAngle, knobBounds.getCentreX(),
+                                                         knobBounds.getCentreY());
+
+        g.saveState();
+        g.addTransform(transform);
+        knobSVG->drawWithin(g, knobBounds, juce::RectanglePlacement::centred, 1.0f);
+        g.restoreState();
+    }
 
-    // Create rotation transform around the center
-    auto transform = juce::AffineTransform::rotation(currentAngle, centerX, centerY);
+    // Progress arc around the knob
+    const auto& arcs = getArcs(slider, knobBounds, arcSize, sliderPos);
 
-    // Apply the transform and draw the knob
-    g.saveState();
-    g.addTransform(transform);
+    g.setColour(juce::Colours::grey);
+    g.fillPath(arcs.background);
 
-    // Draw the SVG knob centered in the bounds
-    knobSVG->drawWithin(g, knobBounds, juce::RectanglePlacement::centred, 1.0f);
+    if (! arcs.filled.isEmpty())
+    {
+        g.setColour(juce::Colour(0xffB69B22));
+        g.fillPath(arcs.filled);
+    }
+}
+
+const DistortionLookAndFeel::ArcCache& DistortionLookAndFeel::getArcs(const juce::Slider& slider,
+                                                                      juce::Rectangle<float> knobBounds,
+                                                                      float arcSize, float sliderPos)
+{
+    // Check if this is a bipolar slider (asymmetry: -1.0 to 1.0)
+    bool isBipolar = (slider.getMinimum() < 0.0 && slider.getMaximum() > 0.0);
+
+    auto& cache = arcCaches[&slider];
+    if (cache.bounds == knobBounds && cache.sliderPos == sliderPos && cache.isBipolar == isBipolar)
+        return cache;
 
-    g.restoreState();
+    cache.bounds = knobBounds;
+    cache.sliderPos = sliderPos;
+    cache.isBipolar = isBipolar;
+    cache.background.clear();
+    cache.filled.clear();
 
-    // Draw progress arc around the knob
     // Use knob center for arc positioning
-    auto arcCenterX = centerX;
-    auto arcCenterY = centerY;
+    auto arcCenterX = knobBounds.getCentreX();
+    auto arcCenterY = knobBounds.getCentreY();
 
     // Arc surrounds the knob with larger diameter
     // Reduce radius slightly to account for stroke thickness to prevent clipping
@@ -61,17 +111,15 @@ void DistortionLookAndFeel::drawRotarySlider(juce::Graphics& g, int x, int y, in
     auto arcStartAngle = -2.356f; // -135 degrees in radians
     auto arcEndAngle = 2.356f;    // +135 degrees in radians
     auto arcCurrentAngle = arcStartAngle + (sliderPos * (arcEndAngle - arcStartAngle));
+    const juce::PathStrokeType stroke(arcThickness);
 
-    // Draw grey background arc (full range)
+    // Grey background arc (full range)
     juce::Path backgroundArc;
     backgroundArc.addCentredArc(arcCenterX, arcCenterY, arcRadius, arcRadius,
                                0.0f, arcStartAngle, arcEndAngle, true);
-    g.setColour(juce::Colours::grey);
-    g.strokePath(backgroundArc, juce::PathStrokeType(arcThickness));
-
-    // Check if this is a bipolar slider (asymmetry: -1.0 to 1.0)
-    bool isBipolar = (slider.getMinimum() < 0.0 && slider.getMaximum() > 0.0);
+    stroke.createStrokedPath(cache.background, backgroundArc);
 
+    juce::Path filledArc;
     if (isBipolar)
     {
         // Bipolar behavior: fill from center outward
@@ -79,7 +127,6 @@ void DistortionLookAndFeel::drawRotarySlider(juce::Graphics& g, int x, int y, in
 
         if (std::abs(sliderPos - 0.5f) > 0.001f) // Only draw if not at center
         {
-            juce::Path filledArc;
             if (sliderPos > 0.5f) // Right side (positive values)
             {
                 filledArc.addCentredArc(arcCenterX, arcCenterY, arcRadius, arcRadius,
@@ -90,8 +137,6 @@ void DistortionLookAndFeel::drawRotarySlider(juce::Graphics& g, int x, int y, in
                 filledArc.addCentredArc(arcCenterX, arcCenterY, arcRadius, arcRadius,
                                        0.0f, arcCurrentAngle, centerAngle, true);
             }
-            g.setColour(juce::Colour(0xffB69B22));
-            g.strokePath(filledArc, juce::PathStrokeType(arcThickness));
         }
     }
     else
@@ -99,11 +144,13 @@ void DistortionLookAndFeel::drawRotarySlider(juce::Graphics& g, int x, int y, in
         // Unipolar behavior: fill from left to current position
         if (sliderPos > 0.0f) // Only draw if there's something to fill
         {
-            juce::Path filledArc;
             filledArc.addCentredArc(arcCenterX, arcCenterY, arcRadius, arcRadius,
                                    0.0f, arcStartAngle, arcCurrentAngle, true);
-            g.setColour(juce::Colour(0xffB69B22));
-            g.strokePath(filledArc, juce::PathStrokeType(arcThickness));
         }
     }
-}
\ No newline at end of file
+
+    if (! filledArc.isEmpty())
+        stroke.createStrokedPath(cache.filled, filledArc);
+
+    return cache;
+}
@@ -1,16 +1,40 @@
 #pragma once
 
 #include <juce_gui_basics/juce_gui_basics.h>
+#include <map>
+#include "KnobSpriteCache.h"
 
-class DistortionLookAndFeel : public juce::LookAndFeel_V4
+class DistortionLookAndFeel : public juce::LookAndFeel_V4,
+                              private juce::ChangeListener
 {
 public:
     DistortionLookAndFeel();
+    ~DistortionLookAndFeel() override;
 
     void drawRotarySlider(juce::Graphics& g, int x, int y, int width, int height,
                          float sliderPos, float rotaryStartAngle, float rotaryEndAngle,
                          juce::Slider& slider) override;
 
 private:
-    std::unique_ptr<juce::Drawable> knobSVG;
-};
\ No newline at end of file
+    // Knob frames shared by every instance; see KnobSpriteCache
+    juce::SharedResourcePointer<KnobSpriteCache> knobSprites;
+
+    // Sliders drawn from the SVG while their sheet was being built, to be
+    // repainted once it is ready
+    std::vector<juce::Component::SafePointer<juce::Slider>> slidersAwaitingSprites;
+    void changeListenerCallback(juce::ChangeBroadcaster* source) override;
+
+    // Stroked outlines of each slider's arcs, kept until its position or
+    // bounds change, so a repaint only fills them
+    struct ArcCache
+    {
+        juce::Rectangle<float> bounds;
+        float sliderPos = -1.0f;
+        bool isBipolar = false;
+        juce::Path background;
+        juce::Path filled;
+    };
+    std::map<const juce::Slider*, ArcCache> arcCaches;
+    const ArcCache& getArcs(const juce::Slider& slider, juce::Rectangle<float> knobBounds,
+                            float arcSize, float sliderPos);
+};
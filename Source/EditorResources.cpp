@@ -0,0 +1,45 @@
+#include "EditorResources.h"
+#include "BinaryData.h"
+
+juce::Typeface::Ptr EditorResources::getSankofaTypeface()
+{
+    if (sankofaTypeface == nullptr)
+        sankofaTypeface = juce::Typeface::createSystemTypefaceFor(
+                BinaryData::SankofaDisplayRegular_ttf,
+                BinaryData::SankofaDisplayRegular_ttfSize);
+
+    return sankofaTypeface;
+}
+
+const juce::Drawable* EditorResources::getKnobDrawable()
+{
+    if (! knobLoaded)
+    {
+        knobLoaded = true;
+        knobSVG = juce::Drawable::createFromImageData(
+            BinaryData::knob1_svg, BinaryData::knob1_svgSize);
+    }
+
+    return knobSVG.get();
+}
+
+juce::Image EditorResources::getScaledBackground(int width, int height, float scale)
+{
+    const auto key = std::make_pair(juce::roundToInt(static_cast<float>(width) * scale),
+                                    juce::roundToInt(static_cast<float>(height) * scale));
+
+    if (auto found = scaledBackgrounds.find(key); found != scaledBackgrounds.end())
+        return found->second;
+
+    if (! background.isValid())
+        background = juce::ImageFormat::loadFrom(BinaryData::background_png,
+                                                 BinaryData::background_pngSize);
+
+    if (! background.isValid() || key.first <= 0 || key.second <= 0)
+        return {};
+
+    // One per display scale in practice, since the editor is not resizable
+    auto scaled = background.rescaled(key.first, key.second, juce::Graphics::highResamplingQuality);
+    scaledBackgrounds[key] = scaled;
+    return scaled;
+}
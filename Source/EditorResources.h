@@ -0,0 +1,35 @@
+#pragma once
+
+#include <juce_gui_basics/juce_gui_basics.h>
+#include <map>
+#include <tuple>
+
+//==============================================================================
+// The editor's embedded assets, decoded once per process and shared by every
+// plugin instance through juce::SharedResourcePointer. Each asset is decoded
+// the first time it is asked for. Message thread only.
+class EditorResources
+{
+public:
+    EditorResources() = default;
+
+    juce::Typeface::Ptr getSankofaTypeface();
+
+    // The parsed knob SVG, or nullptr if it failed to load
+    const juce::Drawable* getKnobDrawable();
+
+    // background.png resampled once to the physical size it is drawn at, so
+    // painting it is a plain 1:1 blit
+    juce::Image getScaledBackground(int width, int height, float scale);
+
+private:
+    juce::Typeface::Ptr sankofaTypeface;
+
+    std::unique_ptr<juce::Drawable> knobSVG;
+    bool knobLoaded = false;
+
+    juce::Image background;
+    std::map<std::pair<int, int>, juce::Image> scaledBackgrounds;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(EditorResources)
+};
@@ -0,0 +1,130 @@
+#include "InstanceLoadTable.h"
+#include <algorithm>
+#include <cmath>
+
+InstanceLoadTable::InstanceLoadTable()
+{
+    for (size_t index = 0; index < slots.size(); ++index)
+        slots[index].id = static_cast<int>(index) + 1;
+}
+
+InstanceLoadTable& InstanceLoadTable::getInstance()
+{
+    static InstanceLoadTable table;
+    return table;
+}
+
+InstanceLoadTable::Slot* InstanceLoadTable::claim()
+{
+    for (auto& slot : slots)
+    {
+        bool expected = false;
+        if (slot.inUse.compare_exchange_strong(expected, true))
+        {
+            slot.clear();
+            return &slot;
+        }
+    }
+
+    return nullptr;
+}
+
+void InstanceLoadTable::release(Slot* slot)
+{
+    if (slot != nullptr)
+        slot->inUse.store(false);
+}
+
+std::vector<InstanceLoadTable::Entry> InstanceLoadTable::getEntries() const
+{
+    std::vector<Entry> entries;
+
+    for (const auto& slot : slots)
+    {
+        if (! slot.inUse.load())
+            continue;
+
+        Entry entry;
+        entry.id = slot.id;
+        for (const auto& character : slot.name)
+        {
+            const char c = character.load(std::memory_order_relaxed);
+            if (c == '\0')
+                break;
+            entry.name += c;
+        }
+
+        entry.averageNs = slot.publishedAverageNs.load(std::memory_order_relaxed);
+        entry.peakNs = slot.publishedPeakNs.load(std::memory_order_relaxed);
+        entry.averageLoad = slot.publishedAverageLoad.load(std::memory_order_relaxed);
+        entry.peakLoad = slot.publishedPeakLoad.load(std::memory_order_relaxed);
+        entry.algorithm = slot.algorithm.load(std::memory_order_relaxed);
+        entry.oversamplingFactor = slot.oversamplingFactor.load(std::memory_order_relaxed);
+        entry.state = slot.state.load(std::memory_order_relaxed);
+        entry.blocks = slot.blocks.load(std::memory_order_relaxed);
+        entries.push_back(std::move(entry));
+    }
+
+    return entries;
+}
+
+//==============================================================================
+void InstanceLoadTable::Slot::clear()
+{
+    averageNs = peakNs = averageLoad = peakLoad = 0.0;
+    publishedAverageNs.store(0.0f);
+    publishedPeakNs.store(0.0f);
+    publishedAverageLoad.store(0.0f);
+    publishedPeakLoad.store(0.0f);
+    algorithm.store(0);
+    oversamplingFactor.store(1);
+    state.store(State::Idle);
+    blocks.store(0);
+    setName({});
+}
+
+void InstanceLoadTable::Slot::update(double processingNs, double blockDurationNs,
+                                     int newAlgorithm, int newOversamplingFactor, State newState)
+{
+    // Averages weighted by how much real time the block covers, so they
+    // behave the same at any block size
+    const double weight = std::min(1.0, blockDurationNs * 1.0e-9 / averageTimeSeconds);
+    const double decay = std::exp(-blockDurationNs * 1.0e-9 / peakDecaySeconds);
+    const double load = blockDurationNs > 0.0 ? processingNs / blockDurationNs : 0.0;
+
+    averageNs += weight * (processingNs - averageNs);
+    averageLoad += weight * (load - averageLoad);
+    peakNs = std::max(processingNs, peakNs * decay);
+    peakLoad = std::max(load, peakLoad * decay);
+
+    constexpr auto relaxed = std::memory_order_relaxed;
+    publishedAverageNs.store(static_cast<float>(averageNs), relaxed);
+    publishedPeakNs.store(static_cast<float>(peakNs), relaxed);
+    publishedAverageLoad.store(static_cast<float>(averageLoad), relaxed);
+    publishedPeakLoad.store(static_cast<float>(peakLoad), relaxed);
+    algorithm.store(newAlgorithm, relaxed);
+    oversamplingFactor.store(newOversamplingFactor, relaxed);
+    state.store(newState, relaxed);
+    blocks.store(blocks.load(relaxed) + 1, relaxed);
+}
+
+void InstanceLoadTable::Slot::setName(const std::string& newName)
+{
+    // Track names are UTF-8, so a long one is cut before the first
+    // character that does not fit whole, never partway through one
+    size_t length = 0;
+    while (length < newName.size())
+    {
+        const auto lead = static_cast<unsigned char>(newName[length]);
+        const size_t characterBytes = lead >= 0xf0 ? 4 : lead >= 0xe0 ? 3 : lead >= 0xc0 ? 2 : 1;
+        if (length + characterBytes > std::min(newName.size(), name.size() - 1))
+            break;
+
+        length += characterBytes;
+    }
+
+    // Written byte by byte; a reader racing this may briefly see a mix of
+    // the old and new names
+    for (size_t index = 0; index < name.size(); ++index)
+        name[index].store(index < length ? newName[index] : '\0', std::memory_order_relaxed);
+}
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+//==============================================================================
+// Live load of every Obliterator instance in the process, so the expensive
+// ones in a large session can be found from any one editor.
+//
+// Each processor claims a Slot when it is created and releases it when it is
+// destroyed. The audio thread updates its slot once per block with relaxed
+// atomic stores only, so it never waits on a reader. Readers copy the table
+// from the message thread; a value read while it changes is at worst one
+// block old.
+//
+// The table is a process-wide singleton that lives until the plugin binary
+// is unloaded. Instances beyond maxInstances are not listed.
+class InstanceLoadTable
+{
+public:
+    static constexpr int maxInstances = 256;
+    static constexpr int maxNameLength = 32;
+
+    // Time constants of the published averages, in seconds of audio
+    static constexpr double averageTimeSeconds = 1.0;
+    static constexpr double peakDecaySeconds = 2.0;
+
+    enum class State
+    {
+        Processing = 0,
+        Idle,
+        Bypassed
+    };
+
+    class Slot
+    {
+    public:
+        // Audio thread, after every block: its processing time and the real
+        // time it covers
+        void update(double processingNs, double blockDurationNs,
+                    int algorithm, int oversamplingFactor, State state);
+
+        // Message thread, e.g. from updateTrackProperties()
+        void setName(const std::string& newName);
+
+        int getId() const { return id; }
+
+    private:
+        friend class InstanceLoadTable;
+
+        int id = 0;
+        std::atomic<bool> inUse { false };
+
+        // Audio thread only
+        double averageNs = 0.0, peakNs = 0.0, averageLoad = 0.0, peakLoad = 0.0;
+
+        // Published
+        std::atomic<float> publishedAverageNs { 0.0f }, publishedPeakNs { 0.0f };
+        std::atomic<float> publishedAverageLoad { 0.0f }, publishedPeakLoad { 0.0f };
+        std::atomic<int> algorithm { 0 }, oversamplingFactor { 1 };
+        std::atomic<State> state { State::Idle };
+        std::atomic<uint32_t> blocks { 0 };
+        std::array<std::atomic<char>, maxNameLength> name {};
+
+        void clear();
+    };
+
+    struct Entry
+    {
+        int id = 0;
+        std::string name;
+        float averageNs = 0.0f, peakNs = 0.0f;      // Per block
+        float averageLoad = 0.0f, peakLoad = 0.0f;  // Processing time / real time
+        int algorithm = 0;
+        int oversamplingFactor = 1;
+        State state = State::Idle;
+        uint32_t blocks = 0;                        // Wraps; only useful for seeing it move
+    };
+
+    static InstanceLoadTable& getInstance();
+
+    // Message thread. claim() returns nullptr when the table is full.
+    Slot* claim();
+    void release(Slot* slot);
+
+    // Every claimed slot, in id order
+    std::vector<Entry> getEntries() const;
+
+private:
+    InstanceLoadTable();
+
+    std::array<Slot, maxInstances> slots;
+};
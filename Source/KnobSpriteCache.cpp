@@ -0,0 +1,76 @@
+#include "KnobSpriteCache.h"
+
+KnobSpriteCache::KnobSpriteCache()
+    : knobSVG(resources->getKnobDrawable())
+{
+}
+
+KnobSpriteCache::~KnobSpriteCache()
+{
+    // Results still queued for the message thread see the weak reference
+    // cleared and are dropped
+    builder.removeAllJobs(true, 5000);
+}
+
+const KnobSpriteCache::Sheet* KnobSpriteCache::getSheet(float knobSize, float scale,
+                                                         float startAngle, float endAngle)
+{
+    const Key key { juce::roundToInt(knobSize * scale), startAngle, endAngle };
+
+    if (auto found = sheets.find(key); found != sheets.end())
+        return &found->second;
+
+    if (knobSVG == nullptr || key.frameSize <= 0 || building.count(key) > 0)
+        return nullptr;
+
+    // The job renders with its own copy, since a Drawable is a Component
+    building.insert(key);
+    std::shared_ptr<juce::Drawable> knob = knobSVG->createCopy();
+    juce::WeakReference<KnobSpriteCache> weakThis(this);
+
+    builder.addJob([knob, key, weakThis]()
+    {
+        auto image = renderSheet(*knob, key);
+
+        juce::MessageManager::callAsync([image, key, weakThis]() mutable
+        {
+            if (auto* cache = weakThis.get())
+            {
+                // Rendered in software off the message thread; moved to the
+                // native image type once, here, so every blit is direct
+                cache->sheets[key] = { juce::NativeImageType().convert(image), key.frameSize };
+                cache->building.erase(key);
+                cache->sendChangeMessage();
+            }
+        });
+    });
+
+    return nullptr;
+}
+
+juce::Image KnobSpriteCache::renderSheet(const juce::Drawable& knob, const Key& key)
+{
+    const int numRows = (numFrames + framesPerRow - 1) / framesPerRow;
+    juce::Image sheet(juce::Image::ARGB, framesPerRow * key.frameSize, numRows * key.frameSize,
+                      true, juce::SoftwareImageType());
+
+    juce::Graphics g(sheet);
+    const auto size = static_cast<float>(key.frameSize);
+
+    for (int frame = 0; frame < numFrames; ++frame)
+    {
+        const auto area = juce::Rectangle<int>((frame % framesPerRow) * key.frameSize,
+                                               (frame / framesPerRow) * key.frameSize,
+                                               key.frameSize, key.frameSize).toFloat();
+        const auto angle = key.startAngle + (key.endAngle - key.startAngle) * static_cast<float>(frame) / static_cast<float>(numFrames - 1);
+
+        // Same placement as drawing the knob live: centred in its square
+        // and rotated about the centre
+        juce::Graphics::ScopedSaveState state(g);
+        g.reduceClipRegion(area.toNearestInt());
+        g.addTransform(juce::AffineTransform::rotation(angle, area.getCentreX(), area.getCentreY()));
+        knob.drawWithin(g, area.withSizeKeepingCentre(size, size), juce::RectanglePlacement::centred, 1.0f);
+    }
+
+    return sheet;
+}
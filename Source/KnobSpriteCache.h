@@ -0,0 +1,78 @@
+#pragma once
+
+#include <juce_gui_basics/juce_gui_basics.h>
+#include <map>
+#include <set>
+#include <tuple>
+#include "EditorResources.h"
+
+//==============================================================================
+// Pre-rendered rotation frames of knob1.svg, shared by every plugin instance
+// in the process through juce::SharedResourcePointer.
+//
+// A sheet holds numFrames rotations spread evenly over a slider's rotary
+// range, for one knob size at one display scale, laid out in a grid so no
+// image side grows too large. Sheets are rasterised on a background thread
+// the first time they are asked for; until then getSheet() returns nullptr
+// and the caller draws the Drawable itself. A change message is sent when a
+// sheet becomes available. Everything except the build runs on the message
+// thread.
+class KnobSpriteCache : public juce::ChangeBroadcaster
+{
+public:
+    static constexpr int numFrames = 128;
+    static constexpr int framesPerRow = 16;
+
+    struct Sheet
+    {
+        juce::Image image;
+        int frameSize = 0; // Physical pixels
+
+        juce::Rectangle<int> getFrameArea(int frame) const
+        {
+            return { (frame % framesPerRow) * frameSize, (frame / framesPerRow) * frameSize,
+                     frameSize, frameSize };
+        }
+    };
+
+    KnobSpriteCache();
+    ~KnobSpriteCache() override;
+
+    // The parsed knob, for drawing while a sheet is being built. May be
+    // nullptr if the SVG failed to load.
+    const juce::Drawable* getKnobDrawable() const { return knobSVG; }
+
+    // The sheet for a knob of knobSize logical pixels at the display scale,
+    // covering rotations from startAngle to endAngle
+    const Sheet* getSheet(float knobSize, float scale, float startAngle, float endAngle);
+
+    // Frame index for a slider position in [0, 1]
+    static int getFrameIndex(float sliderPos)
+    {
+        return juce::jlimit(0, numFrames - 1, juce::roundToInt(sliderPos * static_cast<float>(numFrames - 1)));
+    }
+
+private:
+    struct Key
+    {
+        int frameSize;
+        float startAngle, endAngle;
+
+        bool operator<(const Key& other) const
+        {
+            return std::tie(frameSize, startAngle, endAngle)
+                 < std::tie(other.frameSize, other.startAngle, other.endAngle);
+        }
+    };
+
+    static juce::Image renderSheet(const juce::Drawable& knob, const Key& key);
+
+    juce::SharedResourcePointer<EditorResources> resources;
+    const juce::Drawable* knobSVG = nullptr;
+    std::map<Key, Sheet> sheets;
+    std::set<Key> building;
+    juce::ThreadPool builder { 1 };
+
+    JUCE_DECLARE_WEAK_REFERENCEABLE(KnobSpriteCache)
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(KnobSpriteCache)
+};
@@ -0,0 +1,85 @@
+#include "LevelMeterComponent.h"
+
+LevelMeterComponent::LevelMeterComponent(LevelMeters& source, LevelMeters::Point pointToShow)
+    : meters(source), point(pointToShow)
+{
+    setInterceptsMouseClicks(false, false);
+}
+
+void LevelMeterComponent::updateFromVBlank()
+{
+    if (! isShowing())
+        return;
+
+    // High refresh displays don't need more than maxFrameRate
+    const double now = juce::Time::getMillisecondCounterHiRes();
+    const auto elapsedSeconds = static_cast<float>(juce::jmin(0.1, (now - lastFrameTime) * 0.001));
+    if (now - lastFrameTime < 1000.0 / maxFrameRate)
+        return;
+    lastFrameTime = now;
+
+    const int channelsNow = meters.getNumChannels();
+    bool changed = channelsNow != numChannels;
+    numChannels = channelsNow;
+
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+        auto& shown = channels[static_cast<size_t>(channel)];
+        ChannelDisplay next;
+
+        // Peaks jump up and fall back at a fixed rate
+        const float peakDb = juce::Decibels::gainToDecibels(meters.takePeak(point, channel), minDb);
+        next.peakDb = juce::jmax(peakDb, shown.peakDb - peakFallDbPerSecond * elapsedSeconds, minDb);
+        next.rmsDb = juce::Decibels::gainToDecibels(meters.getRms(point, channel), minDb);
+
+        if (point == LevelMeters::Point::Output)
+            next.saturationDb = juce::jmin(maxSaturationDb, meters.getSaturationDb(channel));
+
+        if (next != shown)
+        {
+            shown = next;
+            changed = true;
+        }
+    }
+
+    if (changed)
+        repaint();
+}
+
+void LevelMeterComponent::paint(juce::Graphics& g)
+{
+    const auto bounds = getLocalBounds().toFloat();
+    g.setColour(juce::Colours::black);
+    g.fillRoundedRectangle(bounds, 3.0f);
+
+    if (numChannels == 0)
+        return;
+
+    const auto area = bounds.reduced(2.0f);
+    const float columnWidth = area.getWidth() / static_cast<float>(numChannels);
+    const auto toY = [&area](float db)
+    {
+        return juce::jmap(juce::jlimit(minDb, maxDb, db), minDb, maxDb, area.getBottom(), area.getY());
+    };
+
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+        const auto& shown = channels[static_cast<size_t>(channel)];
+        const auto column = area.withX(area.getX() + columnWidth * static_cast<float>(channel))
+                                .withWidth(columnWidth)
+                                .reduced(numChannels > 1 ? 0.5f : 0.0f, 0.0f);
+
+        g.setColour(juce::Colour(0xffD4B870).withAlpha(0.8f));
+        g.fillRect(column.withTop(toY(shown.rmsDb)));
+
+        // Clipping shows red
+        g.setColour(shown.peakDb >= 0.0f ? juce::Colours::red : juce::Colour(0xffF0E0B0));
+        g.fillRect(column.withY(toY(shown.peakDb) - 0.5f).withHeight(1.0f));
+
+        if (shown.saturationDb > 0.0f)
+        {
+            g.setColour(juce::Colours::red.withAlpha(0.6f));
+            g.fillRect(column.withHeight(area.getHeight() * shown.saturationDb / maxSaturationDb));
+        }
+    }
+}
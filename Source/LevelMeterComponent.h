@@ -0,0 +1,54 @@
+#pragma once
+
+#include <juce_gui_basics/juce_gui_basics.h>
+#include "LevelMeters.h"
+
+// One bar per channel for either the input or the output of the processor:
+// RMS as a filled bar and the peak as a line that falls back slowly. The
+// output meter also hangs the saturation amount from the top, in red. Values
+// are polled on the display's vblank and repainted only when they move.
+class LevelMeterComponent : public juce::Component
+{
+public:
+    LevelMeterComponent(LevelMeters& source, LevelMeters::Point pointToShow);
+
+    void paint(juce::Graphics& g) override;
+
+private:
+    LevelMeters& meters;
+    const LevelMeters::Point point;
+
+    // Displayed range
+    static constexpr float minDb = -60.0f;
+    static constexpr float maxDb = 6.0f;
+    static constexpr float maxSaturationDb = 24.0f;
+    static constexpr float peakFallDbPerSecond = 20.0f;
+
+    static constexpr double maxFrameRate = 60.0;
+    double lastFrameTime = 0.0;
+    void updateFromVBlank();
+
+    struct ChannelDisplay
+    {
+        float peakDb = minDb;
+        float rmsDb = minDb;
+        float saturationDb = 0.0f;
+
+        bool operator!=(const ChannelDisplay& other) const
+        {
+            // Anything smaller doesn't move a bar by a visible amount
+            constexpr float threshold = 0.1f;
+            return std::abs(peakDb - other.peakDb) > threshold
+                || std::abs(rmsDb - other.rmsDb) > threshold
+                || std::abs(saturationDb - other.saturationDb) > threshold;
+        }
+    };
+
+    int numChannels = 0;
+    std::array<ChannelDisplay, LevelMeters::maxChannels> channels;
+
+    // Last, so it never fires into a partly constructed component
+    juce::VBlankAttachment vBlankAttachment { this, [this]() { updateFromVBlank(); } };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(LevelMeterComponent)
+};
@@ -0,0 +1,126 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include "DSP/DistortionEngine.h"
+
+//==============================================================================
+// Input and output levels for the editor's meters.
+//
+// The engine measures peak and mean square while it processes (see
+// LevelMeasurement). publish() turns those into meter values on the audio
+// thread and stores them with relaxed atomics: peaks are held until the
+// editor takes them, so none is missed between frames, and RMS is averaged
+// over about rmsTimeSeconds. Nothing here locks or allocates.
+//
+// Only the first maxChannels channels are metered.
+class LevelMeters
+{
+public:
+    static constexpr int maxChannels = 16;
+    static constexpr double rmsTimeSeconds = 0.3;
+
+    enum class Point
+    {
+        Input = 0,
+        Output = 1
+    };
+
+    // Called while the audio thread is stopped
+    void prepare(double sampleRate)
+    {
+        currentSampleRate = sampleRate;
+        for (auto& point : points)
+            for (auto& channel : point)
+            {
+                channel.meanSquare = 0.0f;
+                channel.peak.store(0.0f);
+                channel.rms.store(0.0f);
+            }
+    }
+
+    //==============================================================================
+    // Audio thread, after each engine.process() call
+    template <typename SampleType>
+    void publish(const DistortionEngine<SampleType>& engine, int numChannels, int numSamples)
+    {
+        numChannels = std::min(numChannels, maxChannels);
+        meteredChannels.store(numChannels, std::memory_order_relaxed);
+        smallSignalGain.store(static_cast<float>(engine.getSmallSignalGain()), std::memory_order_relaxed);
+
+        // One-pole average of the mean square, stepped once per block
+        const auto decay = static_cast<float>(std::exp(-numSamples / (rmsTimeSeconds * currentSampleRate)));
+
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            update(points[0][static_cast<size_t>(channel)], engine.getInputLevels(channel), decay);
+            update(points[1][static_cast<size_t>(channel)], engine.getOutputLevels(channel), decay);
+        }
+    }
+
+    //==============================================================================
+    // Message thread
+    int getNumChannels() const { return meteredChannels.load(std::memory_order_relaxed); }
+
+    // Highest peak since the last call for the same point and channel
+    float takePeak(Point point, int channel)
+    {
+        return get(point, channel).peak.exchange(0.0f, std::memory_order_relaxed);
+    }
+
+    float getRms(Point point, int channel) const
+    {
+        return get(point, channel).rms.load(std::memory_order_relaxed);
+    }
+
+    // How far the output RMS falls below the input RMS times the chain's
+    // small-signal gain, in dB: 0 while the waveshaper stays linear
+    float getSaturationDb(int channel) const
+    {
+        const float expected = getRms(Point::Input, channel) * smallSignalGain.load(std::memory_order_relaxed);
+        const float actual = getRms(Point::Output, channel);
+        if (expected < 1.0e-5f)
+            return 0.0f;
+
+        return std::max(0.0f, 20.0f * std::log10(expected / std::max(actual, 1.0e-9f)));
+    }
+
+private:
+    struct ChannelMeter
+    {
+        float meanSquare = 0.0f;         // Audio thread only
+        std::atomic<float> peak { 0.0f };
+        std::atomic<float> rms { 0.0f };
+    };
+
+    template <typename SampleType>
+    static void update(ChannelMeter& meter, const LevelMeasurement<SampleType>& levels, float decay)
+    {
+        meter.meanSquare = decay * meter.meanSquare
+                         + (1.0f - decay) * static_cast<float>(levels.getMeanSquare());
+        meter.rms.store(std::sqrt(meter.meanSquare), std::memory_order_relaxed);
+
+        // Not a read-modify-write: a take() landing in between only makes
+        // the old peak show for one more frame
+        const auto peak = static_cast<float>(levels.peak);
+        if (peak > meter.peak.load(std::memory_order_relaxed))
+            meter.peak.store(peak, std::memory_order_relaxed);
+    }
+
+    ChannelMeter& get(Point point, int channel)
+    {
+        return points[static_cast<size_t>(point)][static_cast<size_t>(std::clamp(channel, 0, maxChannels - 1))];
+    }
+
+    const ChannelMeter& get(Point point, int channel) const
+    {
+        return points[static_cast<size_t>(point)][static_cast<size_t>(std::clamp(channel, 0, maxChannels - 1))];
+    }
+
+    double currentSampleRate = 44100.0;
+    std::array<std::array<ChannelMeter, maxChannels>, 2> points;
+    std::atomic<int> meteredChannels { 0 };
+    std::atomic<float> smallSignalGain { 1.0f };
+};
@@ -0,0 +1,72 @@
+#include "LoadMonitorComponent.h"
+
+LoadMonitorComponent::LoadMonitorComponent(int ownInstanceId)
+    : ownId(ownInstanceId)
+{
+}
+
+void LoadMonitorComponent::visibilityChanged()
+{
+    if (isVisible())
+    {
+        timerCallback();
+        startTimerHz(4);
+    }
+    else
+    {
+        stopTimer();
+    }
+}
+
+void LoadMonitorComponent::timerCallback()
+{
+    entries = InstanceLoadTable::getInstance().getEntries();
+    std::stable_sort(entries.begin(), entries.end(), [](const auto& a, const auto& b)
+    {
+        return a.averageLoad > b.averageLoad;
+    });
+
+    repaint();
+}
+
+void LoadMonitorComponent::paint(juce::Graphics& g)
+{
+    g.setColour(juce::Colours::black.withAlpha(0.85f));
+    g.fillRoundedRectangle(getLocalBounds().toFloat(), 14.0f);
+
+    auto area = getLocalBounds().reduced(12, 10);
+    const int rowHeight = 15;
+    g.setFont(juce::FontOptions(juce::Font::getDefaultMonospacedFontName(), 11.0f, juce::Font::plain));
+
+    static const char* algorithmNames[] { "Tanh", "Fold", "Tube" };
+    static const char* stateNames[] { "", "idle", "bypass" };
+
+    g.setColour(juce::Colours::grey);
+    g.drawText(juce::String("Instance").paddedRight(' ', 16) + " " + juce::String("algo")
+                   + juce::String("os").paddedLeft(' ', 4) + juce::String("avg%").paddedLeft(' ', 6)
+                   + juce::String("peak%").paddedLeft(' ', 7) + juce::String("avg us").paddedLeft(' ', 8),
+               area.removeFromTop(rowHeight), juce::Justification::centredLeft, false);
+
+    for (const auto& entry : entries)
+    {
+        if (area.getHeight() < rowHeight)
+            break;
+
+        const auto algorithm = algorithmNames[juce::jlimit(0, 2, entry.algorithm)];
+        const auto state = stateNames[juce::jlimit(0, 2, static_cast<int>(entry.state))];
+
+        const auto text = juce::String(entry.name).substring(0, 16).paddedRight(' ', 16)
+                        + " " + juce::String(algorithm).paddedRight(' ', 4)
+                        + juce::String(entry.oversamplingFactor).paddedLeft(' ', 3) + "x"
+                        + juce::String(entry.averageLoad * 100.0f, 1).paddedLeft(' ', 6)
+                        + juce::String(entry.peakLoad * 100.0f, 1).paddedLeft(' ', 7)
+                        + juce::String(entry.averageNs * 0.001f, 1).paddedLeft(' ', 8)
+                        + " " + state;
+
+        // Anything whose peak comes near real time is worth a look
+        g.setColour(entry.peakLoad > 0.5f ? juce::Colours::red
+                    : entry.id == ownId   ? juce::Colour(0xffD4B870)
+                                          : juce::Colours::white);
+        g.drawText(text, area.removeFromTop(rowHeight), juce::Justification::centredLeft, false);
+    }
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <juce_gui_basics/juce_gui_basics.h>
+#include "InstanceLoadTable.h"
+
+// Every Obliterator instance in the process from the InstanceLoadTable,
+// heaviest first, with this editor's own instance highlighted. Reads the
+// table a few times a second while visible; the audio threads never notice.
+class LoadMonitorComponent : public juce::Component,
+                             private juce::Timer
+{
+public:
+    explicit LoadMonitorComponent(int ownInstanceId);
+
+    void paint(juce::Graphics& g) override;
+    void visibilityChanged() override;
+
+private:
+    void timerCallback() override;
+
+    const int ownId;
+    std::vector<InstanceLoadTable::Entry> entries;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(LoadMonitorComponent)
+};
@@ -1,141 +1,272 @@
 #include "OscilloscopeComponent.h"
 
-OscilloscopeComponent::OscilloscopeComponent()
+namespace
 {
-    audioBuffer.setSize(1, bufferSize);
-    audioBuffer.clear();
-    displayBuffer.resize(bufferSize, 0.0f);
+    struct Choice
+    {
+        const char* name;
+        double seconds;
+    };
+
+    const Choice timebases[] = {
+        { "1 ms", 0.001 }, { "2 ms", 0.002 }, { "5 ms", 0.005 },
+        { "10 ms", 0.01 }, { "20 ms", 0.02 }, { "50 ms", 0.05 },
+        { "100 ms", 0.1 }, { "200 ms", 0.2 }, { "500 ms", 0.5 },
+        { "1 s", 1.0 }, { "2 s", 2.0 }, { "5 s", 5.0 }
+    };
 
-    // Refresh at 30 fps for smooth animation
-    startTimerHz(30);
+    const Choice holdOffs[] = {
+        { "No hold-off", 0.0 }, { "Hold-off 1 ms", 0.001 }, { "Hold-off 2 ms", 0.002 },
+        { "Hold-off 5 ms", 0.005 }, { "Hold-off 10 ms", 0.01 }, { "Hold-off 20 ms", 0.02 },
+        { "Hold-off 50 ms", 0.05 }
+    };
+
+    void styleSelector(juce::ComboBox& selector)
+    {
+        selector.setColour(juce::ComboBox::backgroundColourId, juce::Colours::transparentBlack);
+        selector.setColour(juce::ComboBox::outlineColourId, juce::Colours::darkgrey.withAlpha(0.5f));
+        selector.setColour(juce::ComboBox::textColourId, juce::Colour(0xffD4B870));
+        selector.setColour(juce::ComboBox::arrowColourId, juce::Colour(0xff8F814F));
+    }
 }
 
-OscilloscopeComponent::~OscilloscopeComponent()
+OscilloscopeComponent::OscilloscopeComponent(AnalysisRing& source)
+    : ring(source), reader(source)
 {
-    stopTimer();
+    incoming.resize(AnalysisRing::capacity);
+
+    for (int i = 0; i < static_cast<int>(std::size(timebases)); ++i)
+        timebaseSelector.addItem(timebases[i].name, i + 1);
+    timebaseSelector.setSelectedId(4, juce::dontSendNotification); // 10 ms
+    timebaseSelector.onChange = [this]()
+    {
+        timebaseSeconds = timebases[timebaseSelector.getSelectedItemIndex()].seconds;
+        resetTrigger();
+        needsUpdate = true;
+    };
+    styleSelector(timebaseSelector);
+    addAndMakeVisible(timebaseSelector);
+
+    for (int i = 0; i < static_cast<int>(std::size(holdOffs)); ++i)
+        holdOffSelector.addItem(holdOffs[i].name, i + 1);
+    holdOffSelector.setSelectedId(1, juce::dontSendNotification);
+    holdOffSelector.onChange = [this]()
+    {
+        holdOffSeconds = holdOffs[holdOffSelector.getSelectedItemIndex()].seconds;
+        resetTrigger();
+        needsUpdate = true;
+    };
+    styleSelector(holdOffSelector);
+    addAndMakeVisible(holdOffSelector);
 }
 
-void OscilloscopeComponent::pushBuffer(const float* data, int numSamples)
+void OscilloscopeComponent::updateFromVBlank()
 {
-    // Downsample if needed to fit into our buffer
-    if (numSamples <= 0) return;
-
-    int start1, size1, start2, size2;
-    abstractFifo.prepareToWrite(numSamples, start1, size1, start2, size2);
+    // Hidden or minimised: the ring keeps its newest pairs for later
+    if (! isShowing())
+        return;
 
-    int actualWritten = juce::jmin(numSamples, size1 + size2);
+    // High refresh displays don't need more than maxFrameRate
+    const double now = juce::Time::getMillisecondCounterHiRes();
+    if (now - lastFrameTime < 1000.0 / maxFrameRate)
+        return;
+    lastFrameTime = now;
 
-    if (size1 > 0)
-    {
-        int toCopy = juce::jmin(numSamples, size1);
-        audioBuffer.copyFrom(0, start1, data, toCopy);
-    }
-    if (size2 > 0 && numSamples > size1)
+    // A new sample rate changes what a position means
+    const double rate = ring.getPairRate();
+    if (rate != pairRate)
     {
-        int toCopy = juce::jmin(numSamples - size1, size2);
-        audioBuffer.copyFrom(0, start2, data + size1, toCopy);
+        pairRate = rate;
+        history.clear();
+        resetTrigger();
+        needsUpdate = true;
     }
 
-    abstractFifo.finishedWrite(actualWritten);
+    const int numRead = reader.read(incoming.data(), AnalysisRing::capacity);
+    if (numRead == 0 && ! needsUpdate)
+        return;
+
+    history.append(incoming.data(), numRead);
+    updateTrigger();
+
+    // A static signal (silence, or a triggered steady tone) gives the same
+    // columns again, which needs no repaint
+    if (buildColumns(getNumColumns()) || needsUpdate)
+        repaint();
+
+    needsUpdate = false;
 }
 
-void OscilloscopeComponent::timerCallback()
+void OscilloscopeComponent::resetTrigger()
 {
-    int numReady = abstractFifo.getNumReady();
+    scanPosition = history.getEndPosition();
+    lastTrigger = -1;
+}
 
-    // Only update if we have some samples (relaxed condition)
-    if (numReady >= 64)  // Lower threshold for more frequent updates
+void OscilloscopeComponent::updateTrigger()
+{
+    const auto end = history.getEndPosition();
+    const double length = timebaseSeconds * pairRate;
+    const auto window = static_cast<uint64_t>(std::ceil(length));
+
+    // Scrolling: the newest data at the right edge
+    displayStart = static_cast<double>(end) - length;
+    if (timebaseSeconds > maxTriggeredTimebase || end < window)
+        return;
+
+    // Follow the chain of triggers up to the last one with a complete
+    // window after it, each at least the hold-off after the one before
+    const double pairsPerColumn = length / juce::jmax(1, getWidth());
+    const auto holdOff = juce::jmax<uint64_t>(1, static_cast<uint64_t>(holdOffSeconds * pairRate));
+    const auto lastStart = end - window;
+
+    auto from = juce::jmax(scanPosition, history.getOldestPosition());
+    if (lastTrigger >= 0)
+        from = juce::jmax(from, static_cast<uint64_t>(lastTrigger) + holdOff);
+
+    while (from < lastStart)
     {
-        // Read up to bufferSize samples
-        int samplesToRead = juce::jmin(numReady, bufferSize);
-
-        int start1, size1, start2, size2;
-        abstractFifo.prepareToRead(samplesToRead, start1, size1, start2, size2);
-
-        juce::ScopedLock lock(pathCreationLock);
-
-        // Copy samples to display buffer
-        int writePos = 0;
-        if (size1 > 0)
-        {
-            for (int i = 0; i < size1; ++i)
-                displayBuffer[writePos++] = audioBuffer.getSample(0, start1 + i);
-        }
-        if (size2 > 0)
-        {
-            for (int i = 0; i < size2; ++i)
-                displayBuffer[writePos++] = audioBuffer.getSample(0, start2 + i);
-        }
-
-        abstractFifo.finishedRead(size1 + size2);
+        const auto trigger = history.findRisingEdge(from, lastStart, 0.0f, pairsPerColumn);
+        if (trigger < 0)
+            break;
+
+        lastTrigger = trigger;
+        from = static_cast<uint64_t>(trigger) + holdOff;
     }
 
-    // Always repaint to show updates
-    repaint();
+    scanPosition = juce::jmax(scanPosition, lastStart);
+
+    // Hold the last triggered frame for a while, then fall back to scrolling
+    if (lastTrigger >= 0 && static_cast<double>(end - static_cast<uint64_t>(lastTrigger)) <= length + autoTriggerSeconds * pairRate)
+        displayStart = static_cast<double>(lastTrigger) - triggerPosition * length;
 }
 
 void OscilloscopeComponent::paint(juce::Graphics& g)
 {
-    // Draw black background with rounded corners
-    auto bounds = getLocalBounds().toFloat();
-    g.setColour(juce::Colours::black);
-    g.fillRoundedRectangle(bounds, 14.0f);
+    const auto bounds = getLocalBounds().toFloat();
+    if (bounds.isEmpty())
+        return;
 
-    juce::ScopedLock lock(pathCreationLock);
+    const float scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+    updateRenderCaches(bounds, scale);
 
-    bounds = bounds.reduced(4.0f);
-    auto centerY = bounds.getCentreY();
-    auto heightScale = bounds.getHeight() * 0.4f;
+    g.drawImage(backgroundImage, bounds);
 
-    // Draw center line for reference
-    g.setColour(juce::Colours::darkgrey.withAlpha(0.3f));
-    g.drawLine(bounds.getX(), centerY, bounds.getRight(), centerY, 1.0f);
+    // The columns are normally ready from the last update, unless the size
+    // or display scale has changed since
+    const auto area = getWaveformArea();
+    const int numColumns = getNumColumns();
+    if (static_cast<int>(columns.size()) != numColumns)
+        buildColumns(numColumns);
 
-    // Create waveform path
-    juce::Path waveformPath;
-    bool pathStarted = false;
+    const auto waveformPath = createWaveformPath(area, area.getWidth() / static_cast<float>(numColumns));
 
-    for (size_t i = 0; i < displayBuffer.size(); ++i)
+    // Glow: the waveform stroked thick at a quarter of the resolution, and
+    // softened by the bilinear stretch back to full size
     {
-        float x = bounds.getX() + (i / (float)displayBuffer.size()) * bounds.getWidth();
-        float y = centerY - (displayBuffer[i] * heightScale);
-
-        if (!pathStarted)
-        {
-            waveformPath.startNewSubPath(x, y);
-            pathStarted = true;
-        }
-        else
-        {
-            waveformPath.lineTo(x, y);
-        }
+        glowImage.clear(glowImage.getBounds());
+        juce::Graphics glow(glowImage);
+        glow.addTransform(juce::AffineTransform::scale(scale / static_cast<float>(glowDownscale)));
+        glow.setColour(juce::Colour(0xff8F814F).withAlpha(0.5f));
+        glow.strokePath(waveformPath, juce::PathStrokeType(6.0f));
     }
 
-    // Draw glow effect with multiple passes - glowing gold color
-    // Outer glow (most transparent, thickest)
-    g.setColour(juce::Colour(0xff8F814F).withAlpha(0.1f));
-    g.strokePath(waveformPath, juce::PathStrokeType(6.0f));
-
-    // Middle glow
-    g.setColour(juce::Colour(0xff8F814F).withAlpha(0.3f));
-    g.strokePath(waveformPath, juce::PathStrokeType(3.0f));
-
-    // Inner glow
-    g.setColour(juce::Colour(0xff8F814F).withAlpha(0.6f));
-    g.strokePath(waveformPath, juce::PathStrokeType(2.0f));
+    g.setImageResamplingQuality(juce::Graphics::mediumResamplingQuality);
+    g.drawImage(glowImage, bounds);
 
     // Core line (brightest, thinnest)
     g.setColour(juce::Colour(0xffD4B870));
     g.strokePath(waveformPath, juce::PathStrokeType(1.0f));
-
-    // Debug: Show buffer status
-    g.setColour(juce::Colours::white);
-    g.setFont(10.0f);
-    g.drawText("Samples: " + juce::String(abstractFifo.getNumReady()),
-               bounds.getX(), bounds.getY(), 100, 15, juce::Justification::left);
 }
 
 void OscilloscopeComponent::resized()
 {
-    // Nothing to do here for now
+    // The caches are sized for the old bounds
+    backgroundImage = {};
+    glowImage = {};
+    needsUpdate = true;
+
+    auto controls = getLocalBounds().reduced(8, 6).removeFromTop(20);
+    timebaseSelector.setBounds(controls.removeFromLeft(80));
+    holdOffSelector.setBounds(controls.removeFromRight(120));
+}
+
+void OscilloscopeComponent::updateRenderCaches(juce::Rectangle<float> bounds, float scale)
+{
+    if (backgroundImage.isValid() && glowImage.isValid() && scale == cachedScale)
+        return;
+
+    cachedScale = scale;
+    const int width = juce::jmax(1, juce::roundToInt(bounds.getWidth() * scale));
+    const int height = juce::jmax(1, juce::roundToInt(bounds.getHeight() * scale));
+
+    // Black background with rounded corners and the centre reference line
+    backgroundImage = juce::Image(juce::Image::ARGB, width, height, true);
+    {
+        juce::Graphics bg(backgroundImage);
+        bg.addTransform(juce::AffineTransform::scale(scale));
+
+        bg.setColour(juce::Colours::black);
+        bg.fillRoundedRectangle(bounds, 14.0f);
+
+        const auto area = getWaveformArea();
+        bg.setColour(juce::Colours::darkgrey.withAlpha(0.3f));
+        bg.drawLine(area.getX(), area.getCentreY(), area.getRight(), area.getCentreY(), 1.0f);
+    }
+
+    glowImage = juce::Image(juce::Image::ARGB,
+                            juce::jmax(1, width / glowDownscale),
+                            juce::jmax(1, height / glowDownscale), true);
+}
+
+int OscilloscopeComponent::getNumColumns() const
+{
+    // One per physical pixel, at the scale of the last paint
+    const float scale = cachedScale > 0.0f ? cachedScale : 1.0f;
+    return juce::jmax(1, juce::roundToInt(getWaveformArea().getWidth() * scale));
+}
+
+bool OscilloscopeComponent::buildColumns(int numColumns)
+{
+    nextColumns.resize(static_cast<size_t>(numColumns));
+
+    // Before there is any history, or right after a rate change, draw silence
+    if (pairRate <= 0.0 || ! history.render(displayStart, timebaseSeconds * pairRate, nextColumns.data(), numColumns))
+        std::fill(nextColumns.begin(), nextColumns.end(), AnalysisRing::MinMax { 0.0f, 0.0f });
+
+    const bool changed = nextColumns.size() != columns.size()
+                      || ! std::equal(nextColumns.begin(), nextColumns.end(), columns.begin(),
+                                      [](const auto& a, const auto& b) { return a.min == b.min && a.max == b.max; });
+
+    if (changed)
+        std::swap(columns, nextColumns);
+
+    return changed;
+}
+
+juce::Path OscilloscopeComponent::createWaveformPath(juce::Rectangle<float> area, float columnWidth) const
+{
+    // Down to the minimum and up to the maximum of each column, so the
+    // envelope is drawn whatever the zoom
+    const auto centerY = area.getCentreY();
+    const auto heightScale = area.getHeight() * 0.4f;
+
+    juce::Path waveformPath;
+    waveformPath.preallocateSpace(static_cast<int>(columns.size()) * 6 + 3);
+
+    for (size_t i = 0; i < columns.size(); ++i)
+    {
+        const float x = area.getX() + (static_cast<float>(i) + 0.5f) * columnWidth;
+        const float yMin = centerY - columns[i].min * heightScale;
+        const float yMax = centerY - columns[i].max * heightScale;
+
+        if (i == 0)
+            waveformPath.startNewSubPath(x, yMin);
+        else
+            waveformPath.lineTo(x, yMin);
+
+        waveformPath.lineTo(x, yMax);
+    }
+
+    return waveformPath;
 }
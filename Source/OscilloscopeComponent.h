@@ -1,29 +1,83 @@
 #pragma once
 
 #include <juce_gui_basics/juce_gui_basics.h>
-#include <juce_audio_basics/juce_audio_basics.h>
+#include "DSP/AnalysisRing.h"
+#include "ScopeHistory.h"
 
-class OscilloscopeComponent : public juce::Component, private juce::Timer
+// Draws the processor's output from its AnalysisRing. The audio thread
+// never touches this component.
+//
+// Up to maxTriggeredTimebase the display starts at a rising zero crossing.
+// Crossings are chained through the stream with a hold-off, so on a signal
+// with several crossings per period the same one is picked every time. With
+// no trigger for a while, or at longer timebases, the view scrolls instead.
+//
+// Updates run on the display's vertical blank, at most maxFrameRate times a
+// second, and only while the component is on screen. A repaint is issued
+// only when the columns to draw have actually changed, so a stopped
+// transport, silence or a hidden editor cost next to nothing.
+class OscilloscopeComponent : public juce::Component
 {
 public:
-    OscilloscopeComponent();
-    ~OscilloscopeComponent() override;
+    explicit OscilloscopeComponent(AnalysisRing& source);
 
     void paint(juce::Graphics& g) override;
     void resized() override;
 
-    // Called from audio thread to push new samples
-    void pushBuffer(const float* data, int numSamples);
-
 private:
-    void timerCallback() override;
+    static constexpr double maxFrameRate = 60.0;
+    double lastFrameTime = 0.0;
+    bool needsUpdate = true; // Set when the view changes without new data
+    void updateFromVBlank();
+
+    // Only the message thread reads the ring and paints, so nothing here
+    // needs a lock
+    AnalysisRing& ring;
+    AnalysisRing::Reader reader;
+    std::vector<AnalysisRing::MinMax> incoming;
+    ScopeHistory history;
+    double pairRate = 0.0;
+
+    // Timebase and trigger
+    static constexpr double maxTriggeredTimebase = 0.5;
+    static constexpr double autoTriggerSeconds = 0.2; // Free-run after this long without a trigger
+    static constexpr double triggerPosition = 0.1;    // Fraction of the window before the trigger
+    double timebaseSeconds = 0.01;
+    double holdOffSeconds = 0.0;
+    uint64_t scanPosition = 0;
+    int64_t lastTrigger = -1;
+    double displayStart = 0.0;
+
+    juce::ComboBox timebaseSelector;
+    juce::ComboBox holdOffSelector;
+
+    void resetTrigger();
+    void updateTrigger();
+
+    // Rendering. Everything is sized in physical pixels for the current
+    // display scale, and rebuilt only when the size or scale changes.
+    void updateRenderCaches(juce::Rectangle<float> bounds, float scale);
+    int getNumColumns() const;
+    bool buildColumns(int numColumns);
+    juce::Rectangle<float> getWaveformArea() const { return getLocalBounds().toFloat().reduced(4.0f); }
+    juce::Path createWaveformPath(juce::Rectangle<float> area, float columnWidth) const;
+
+    // Rounded background and centre line, drawn once
+    juce::Image backgroundImage;
+    float cachedScale = 0.0f;
+
+    // One min/max pair per pixel column of the display, and the next frame
+    // to compare against it
+    std::vector<AnalysisRing::MinMax> columns;
+    std::vector<AnalysisRing::MinMax> nextColumns;
 
-    static constexpr int bufferSize = 512;
-    juce::AudioBuffer<float> audioBuffer;
-    juce::AbstractFifo abstractFifo { bufferSize };
+    // The glow is the waveform drawn thick into a low resolution image and
+    // stretched over the display, which blurs it in the same pass
+    static constexpr int glowDownscale = 4;
+    juce::Image glowImage;
 
-    std::vector<float> displayBuffer;
-    juce::CriticalSection pathCreationLock;
+    // Last, so it never fires into a partly constructed component
+    juce::VBlankAttachment vBlankAttachment { this, [this]() { updateFromVBlank(); } };
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(OscilloscopeComponent)
 };
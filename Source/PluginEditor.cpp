@@ -1,16 +1,21 @@
 #include "PluginEditor.h"
-#include "BinaryData.h"
 #include "PluginProcessor.h"
 
 //==============================================================================
 AudioPluginAudioProcessorEditor::AudioPluginAudioProcessorEditor(
         AudioPluginAudioProcessor& p) :
-    AudioProcessorEditor(&p), processorRef(p)
+    AudioProcessorEditor(&p), processorRef(p),
+    oscilloscope(p.getOutputAnalysis()),
+    spectrum(p.getSpectrumAnalyzer()),
+    inputMeter(p.getLevelMeters(), LevelMeters::Point::Input),
+    outputMeter(p.getLevelMeters(), LevelMeters::Point::Output),
+    loadMonitor(p.getLoadSlotId())
+#if OBLITERATOR_PROFILING
+    , profilerOverlay(p.getProfiler())
+#endif
 {
-    // Load custom font
-    sankofaFont = juce::Font(juce::Typeface::createSystemTypefaceFor(
-            BinaryData::SankofaDisplayRegular_ttf,
-            BinaryData::SankofaDisplayRegular_ttfSize));
+    // Custom font, shared with the other instances
+    sankofaFont = juce::Font(resources->getSankofaTypeface());
 
     // Configure drive slider
     driveSlider.setSliderStyle(juce::Slider::RotaryHorizontalVerticalDrag);
@@ -165,13 +170,100 @@ AudioPluginAudioProcessorEditor::AudioPluginAudioProcessorEditor(
             juce::AudioProcessorValueTreeState::ComboBoxAttachment>(
             processorRef.parameters, "algorithm", algorithmSelector);
 
-    // Load background image
-    backgroundImage = juce::ImageCache::getFromMemory(
-            BinaryData::background_png, BinaryData::background_pngSize);
+    // Engine settings, in rows down the right-hand column
+    foldDepthSlider.setSliderStyle(juce::Slider::LinearHorizontal);
+    foldDepthSlider.setTextBoxStyle(juce::Slider::TextBoxRight, false, 44, 20);
+    addAndMakeVisible(foldDepthSlider);
 
-    // Setup oscilloscope
+    foldDepthLabel.setText("Fold Depth", juce::dontSendNotification);
+    foldDepthLabel.setJustificationType(juce::Justification::centredRight);
+    foldDepthLabel.setFont(sankofaFont.withHeight(16.0f));
+    addAndMakeVisible(foldDepthLabel);
+
+    // One selector per choice parameter, with the items taken from the
+    // parameter so the two never disagree
+    const auto configureSetting = [this](juce::ComboBox& selector, juce::Label& label,
+                                         const juce::String& text, const juce::String& parameterID)
+    {
+        if (auto* choice = dynamic_cast<juce::AudioParameterChoice*>(
+                    processorRef.parameters.getParameter(parameterID)))
+            selector.addItemList(choice->choices, 1);
+        addAndMakeVisible(selector);
+
+        label.setText(text, juce::dontSendNotification);
+        label.setJustificationType(juce::Justification::centredRight);
+        label.setFont(sankofaFont.withHeight(16.0f));
+        addAndMakeVisible(label);
+    };
+
+    configureSetting(oversamplingSelector, oversamplingLabel, "Oversampling", "oversampling");
+    configureSetting(oversamplingPhaseSelector, oversamplingPhaseLabel, "Filter", "osphase");
+    configureSetting(antialiasingSelector, antialiasingLabel, "Antialiasing", "antialiasing");
+    configureSetting(precisionSelector, precisionLabel, "Precision", "precision");
+
+    bypassButton.setClickingTogglesState(true);
+    addAndMakeVisible(bypassButton);
+
+    oversamplingAttachment = std::make_unique<
+            juce::AudioProcessorValueTreeState::ComboBoxAttachment>(
+            processorRef.parameters, "oversampling", oversamplingSelector);
+    oversamplingPhaseAttachment = std::make_unique<
+            juce::AudioProcessorValueTreeState::ComboBoxAttachment>(
+            processorRef.parameters, "osphase", oversamplingPhaseSelector);
+    antialiasingAttachment = std::make_unique<
+            juce::AudioProcessorValueTreeState::ComboBoxAttachment>(
+            processorRef.parameters, "antialiasing", antialiasingSelector);
+    precisionAttachment = std::make_unique<
+            juce::AudioProcessorValueTreeState::ComboBoxAttachment>(
+            processorRef.parameters, "precision", precisionSelector);
+    foldDepthAttachment = std::make_unique<
+            juce::AudioProcessorValueTreeState::SliderAttachment>(
+            processorRef.parameters, "folddepth", foldDepthSlider);
+    bypassAttachment = std::make_unique<
+            juce::AudioProcessorValueTreeState::ButtonAttachment>(
+            processorRef.parameters, "bypass", bypassButton);
+
+    // The background covers the whole editor, so nothing behind it needs
+    // painting
+    setOpaque(true);
+
+    // Setup oscilloscope and spectrum
     addAndMakeVisible(oscilloscope);
-    processorRef.setOscilloscopeComponent(&oscilloscope);
+    addAndMakeVisible(spectrum);
+    addAndMakeVisible(inputMeter);
+    addAndMakeVisible(outputMeter);
+
+    // The load monitor and the profiler overlay share the oscilloscope's
+    // place, so showing one hides the other
+    addChildComponent(loadMonitor);
+    loadButton.setClickingTogglesState(true);
+    loadButton.onClick = [this]()
+    {
+        loadMonitor.setVisible(loadButton.getToggleState());
+#if OBLITERATOR_PROFILING
+        if (loadButton.getToggleState())
+        {
+            profilerButton.setToggleState(false, juce::dontSendNotification);
+            profilerOverlay.setVisible(false);
+        }
+#endif
+    };
+    addAndMakeVisible(loadButton);
+
+#if OBLITERATOR_PROFILING
+    addChildComponent(profilerOverlay);
+    profilerButton.setClickingTogglesState(true);
+    profilerButton.onClick = [this]()
+    {
+        profilerOverlay.setVisible(profilerButton.getToggleState());
+        if (profilerButton.getToggleState())
+        {
+            loadButton.setToggleState(false, juce::dontSendNotification);
+            loadMonitor.setVisible(false);
+        }
+    };
+    addAndMakeVisible(profilerButton);
+#endif
 
     // Make sure that before the constructor has finished, you've set the
     // editor's size to whatever you need it to be.
@@ -186,9 +278,6 @@ AudioPluginAudioProcessorEditor::AudioPluginAudioProcessorEditor(
 
 AudioPluginAudioProcessorEditor::~AudioPluginAudioProcessorEditor()
 {
-    // Clear the oscilloscope pointer to prevent dangling pointer access
-    processorRef.setOscilloscopeComponent(nullptr);
-
     // Reset LookAndFeel to prevent dangling reference
     driveSlider.setLookAndFeel(nullptr);
     asymmetrySlider.setLookAndFeel(nullptr);
@@ -200,10 +289,14 @@ AudioPluginAudioProcessorEditor::~AudioPluginAudioProcessorEditor()
 //==============================================================================
 void AudioPluginAudioProcessorEditor::paint(juce::Graphics& g)
 {
-    // Draw background image if loaded, otherwise fallback to solid color
-    if (backgroundImage.isValid())
+    // Draw the background pre-scaled for this display, otherwise fallback
+    // to solid color
+    const float scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+    const auto background = resources->getScaledBackground(getWidth(), getHeight(), scale);
+
+    if (background.isValid())
     {
-        g.drawImage(backgroundImage, getLocalBounds().toFloat(),
+        g.drawImage(background, getLocalBounds().toFloat(),
                     juce::RectanglePlacement::stretchToFit);
     }
     else
@@ -232,6 +325,14 @@ void AudioPluginAudioProcessorEditor::resized()
     int oscY = 120; // Moved up slightly
     oscilloscope.setBounds(oscX, oscY, oscWidth, oscHeight);
 
+    loadMonitor.setBounds(oscilloscope.getBounds());
+    loadButton.setBounds(bounds.getWidth() - 104, 8, 44, 20);
+
+#if OBLITERATOR_PROFILING
+    profilerOverlay.setBounds(oscilloscope.getBounds());
+    profilerButton.setBounds(bounds.getWidth() - 52, 8, 44, 20);
+#endif
+
     // Position algorithm selector and label to the right of oscilloscope
     int algorithmWidth = 150;
     int algorithmHeight = 25;
@@ -243,6 +344,36 @@ void AudioPluginAudioProcessorEditor::resized()
     int algorithmLabelY = algorithmY - 25;
     algorithmLabel.setBounds(algorithmX, algorithmLabelY, algorithmWidth, 20);
 
+    // Position spectrum below the algorithm selector, down to the bottom of
+    // the oscilloscope
+    int spectrumY = algorithmY + algorithmHeight + 15;
+    spectrum.setBounds(algorithmX, spectrumY, bounds.getWidth() - algorithmX - 20,
+                       oscY + oscHeight - spectrumY);
+
+    // Engine settings in rows down the right-hand column: label on the
+    // left, control on the right
+    const int settingsLabelWidth = 90;
+    const int settingsRowHeight = 22;
+    auto settingsArea = juce::Rectangle<int>(algorithmX, oscY + oscHeight + 20,
+                                             bounds.getWidth() - algorithmX - 20,
+                                             bounds.getHeight() - oscY - oscHeight - 30);
+
+    const auto layoutSetting = [&](juce::Label& label, juce::Component& control)
+    {
+        auto row = settingsArea.removeFromTop(settingsRowHeight);
+        settingsArea.removeFromTop(4);
+        label.setBounds(row.removeFromLeft(settingsLabelWidth));
+        control.setBounds(row.withTrimmedLeft(6));
+    };
+
+    layoutSetting(oversamplingLabel, oversamplingSelector);
+    layoutSetting(oversamplingPhaseLabel, oversamplingPhaseSelector);
+    layoutSetting(antialiasingLabel, antialiasingSelector);
+    layoutSetting(precisionLabel, precisionSelector);
+    layoutSetting(foldDepthLabel, foldDepthSlider);
+    bypassButton.setBounds(settingsArea.removeFromTop(settingsRowHeight)
+                                   .withTrimmedLeft(settingsLabelWidth + 6));
+
     // Define knob sizes (including arcs)
     const int driveKnobSize = 115; // Arc diameter for drive
     const int smallKnobSize = 68; // Arc diameter for other knobs
@@ -282,6 +413,14 @@ void AudioPluginAudioProcessorEditor::resized()
             juce::Rectangle<int>(smallKnobSize, smallKnobSize)
                     .withCentre(juce::Point<int>(toneCenterX, toneCenterY));
 
+    // Level meters in the gaps either side of the drive knob
+    const int meterWidth = 12;
+    const int meterHeight = 76;
+    inputMeter.setBounds(juce::Rectangle<int>(meterWidth, meterHeight)
+                                 .withCentre(juce::Point<int>(driveArea.getX() - 10, driveCenterY)));
+    outputMeter.setBounds(juce::Rectangle<int>(meterWidth, meterHeight)
+                                  .withCentre(juce::Point<int>(driveArea.getRight() + 10, driveCenterY)));
+
     // Set slider bounds
     driveSlider.setBounds(driveArea);
     asymmetrySlider.setBounds(asymmetryArea);
@@ -2,7 +2,12 @@
 
 #include "PluginProcessor.h"
 #include "DistortionLookAndFeel.h"
+#include "EditorResources.h"
+#include "LevelMeterComponent.h"
+#include "LoadMonitorComponent.h"
 #include "OscilloscopeComponent.h"
+#include "ProfilerOverlay.h"
+#include "SpectrumComponent.h"
 
 //==============================================================================
 class AudioPluginAudioProcessorEditor final : public juce::AudioProcessorEditor
@@ -20,8 +25,8 @@ private:
     // access the processor object that created it.
     AudioPluginAudioProcessor& processorRef;
 
-    // Background image
-    juce::Image backgroundImage;
+    // Font, background and knob, decoded once per process
+    juce::SharedResourcePointer<EditorResources> resources;
 
     // Custom font
     juce::Font sankofaFont;
@@ -32,6 +37,24 @@ private:
     // Oscilloscope
     OscilloscopeComponent oscilloscope;
 
+    // Input and output spectra
+    SpectrumComponent spectrum;
+
+    // Input and output levels, either side of the drive knob
+    LevelMeterComponent inputMeter;
+    LevelMeterComponent outputMeter;
+
+    // Load of every instance in the process, over the oscilloscope while
+    // the Load button is down
+    LoadMonitorComponent loadMonitor;
+    juce::TextButton loadButton { "Load" };
+
+#if OBLITERATOR_PROFILING
+    // Stage timings over the oscilloscope, shown with the DSP button
+    ProfilerOverlay profilerOverlay;
+    juce::TextButton profilerButton { "DSP" };
+#endif
+
     // UI Components
     juce::Slider driveSlider;
     juce::Label driveLabel;
@@ -51,6 +74,21 @@ private:
     juce::ComboBox algorithmSelector;
     juce::Label algorithmLabel;
 
+    // Engine settings, in rows down the right-hand column.
+    // Oversampling and its filter are not automatable, so hosts may not
+    // list them at all.
+    juce::ComboBox oversamplingSelector;
+    juce::Label oversamplingLabel;
+    juce::ComboBox oversamplingPhaseSelector;
+    juce::Label oversamplingPhaseLabel;
+    juce::ComboBox antialiasingSelector;
+    juce::Label antialiasingLabel;
+    juce::ComboBox precisionSelector;
+    juce::Label precisionLabel;
+    juce::Slider foldDepthSlider;
+    juce::Label foldDepthLabel;
+    juce::TextButton bypassButton { "Bypass" };
+
     // Parameter attachments
     std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> driveAttachment;
     std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> asymmetryAttachment;
@@ -58,6 +96,12 @@ private:
     std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> dryWetAttachment;
     std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> toneAttachment;
     std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> algorithmAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> oversamplingAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> oversamplingPhaseAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> antialiasingAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> precisionAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> foldDepthAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ButtonAttachment> bypassAttachment;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AudioPluginAudioProcessorEditor)
 };
@@ -1,7 +1,7 @@
 #include "PluginProcessor.h"
 #include <JuceHeader.h>
 #include "PluginEditor.h"
-#include "OscilloscopeComponent.h"
+#include <chrono>
 
 //==============================================================================
 AudioPluginAudioProcessor::AudioPluginAudioProcessor() :
@@ -16,6 +16,30 @@ AudioPluginAudioProcessor::AudioPluginAudioProcessor() :
                     ),
     parameters(*this, nullptr, "Parameters", createParameterLayout())
 {
+    parameterPointers.drive = parameters.getRawParameterValue("drive");
+    parameterPointers.asymmetry = parameters.getRawParameterValue("asymmetry");
+    parameterPointers.subOctave = parameters.getRawParameterValue("suboctave");
+    parameterPointers.dryWet = parameters.getRawParameterValue("drywet");
+    parameterPointers.tone = parameters.getRawParameterValue("tone");
+    parameterPointers.foldDepth = parameters.getRawParameterValue("folddepth");
+    parameterPointers.algorithm = parameters.getRawParameterValue("algorithm");
+    parameterPointers.precision = parameters.getRawParameterValue("precision");
+    parameterPointers.antialiasing = parameters.getRawParameterValue("antialiasing");
+    parameterPointers.oversampling = parameters.getRawParameterValue("oversampling");
+    parameterPointers.oversamplingPhase = parameters.getRawParameterValue("osphase");
+    parameterPointers.bypass = parameters.getRawParameterValue("bypass");
+
+    parameters.addParameterListener("oversampling", this);
+    parameters.addParameterListener("osphase", this);
+
+#if OBLITERATOR_PROFILING
+    floatEngine.setProfiler(&profiler);
+    doubleEngine.setProfiler(&profiler);
+#endif
+
+    loadSlot = InstanceLoadTable::getInstance().claim();
+    if (loadSlot != nullptr)
+        loadSlot->setName("Obliterator " + std::to_string(loadSlot->getId()));
 }
 
 juce::AudioProcessorValueTreeState::ParameterLayout
@@ -40,10 +64,38 @@ AudioPluginAudioProcessor::createParameterLayout()
     params.push_back(std::make_unique<juce::AudioParameterChoice>(
             "algorithm", "Algorithm",
             juce::StringArray{"Tanh", "Foldback", "Tube"}, 0));
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+            "folddepth", "Fold Depth",
+            juce::NormalisableRange<float>(0.0f, 20.0f, 0.01f), 20.0f));
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(
+            "precision", "Precision",
+            juce::StringArray{"Reference", "Accurate", "Fast"}, 1));
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(
+            "antialiasing", "Antialiasing",
+            juce::StringArray{"Off", "ADAA 1st Order", "ADAA 2nd Order"}, 0));
+
+    // Oversampling changes the plugin latency, so it is not automatable
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(
+            "oversampling", "Oversampling",
+            juce::StringArray{"1x", "2x", "4x", "8x"}, 0,
+            juce::AudioParameterChoiceAttributes().withAutomatable(false)));
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(
+            "osphase", "Oversampling Filter",
+            juce::StringArray{"Linear Phase", "Minimum Phase"}, 0,
+            juce::AudioParameterChoiceAttributes().withAutomatable(false)));
+
+    // Exposed to the host as its bypass switch through getBypassParameter()
+    params.push_back(std::make_unique<juce::AudioParameterBool>(
+            "bypass", "Bypass", false));
     return {params.begin(), params.end()};
 }
 
-AudioPluginAudioProcessor::~AudioPluginAudioProcessor() {}
+AudioPluginAudioProcessor::~AudioPluginAudioProcessor()
+{
+    parameters.removeParameterListener("oversampling", this);
+    parameters.removeParameterListener("osphase", this);
+    InstanceLoadTable::getInstance().release(loadSlot);
+}
 
 //==============================================================================
 
@@ -79,7 +131,13 @@ bool AudioPluginAudioProcessor::isMidiEffect() const
 #endif
 }
 
-double AudioPluginAudioProcessor::getTailLengthSeconds() const { return 0.0; }
+double AudioPluginAudioProcessor::getTailLengthSeconds() const
+{
+    // The filters ring on after the input stops, and the engine skips work
+    // once they have decayed, so hosts may stop calling us after this long
+    return isUsingDoublePrecision() ? doubleEngine.getTailLengthSeconds()
+                                    : floatEngine.getTailLengthSeconds();
+}
 
 int AudioPluginAudioProcessor::getNumPrograms()
 {
@@ -111,9 +169,22 @@ void AudioPluginAudioProcessor::changeProgramName(int index,
 void AudioPluginAudioProcessor::prepareToPlay(double sampleRate,
                                               int samplesPerBlock)
 {
-    // Use this method as the place to do any pre-playback
-    // initialisation that you need..
-    juce::ignoreUnused(sampleRate, samplesPerBlock);
+    // Allocates the oversampling filters and the dry delay line for the
+    // largest block the host will send. The host sets the processing
+    // precision before calling this, so only that engine needs preparing.
+    const int numChannels = juce::jmax(getTotalNumInputChannels(), getTotalNumOutputChannels());
+    if (isUsingDoublePrecision())
+        doubleEngine.prepare(sampleRate, samplesPerBlock, numChannels);
+    else
+        floatEngine.prepare(sampleRate, samplesPerBlock, numChannels);
+
+    outputAnalysis.prepare(sampleRate);
+    spectrumAnalyzer.prepare(sampleRate);
+    levelMeters.prepare(sampleRate);
+#if OBLITERATOR_PROFILING
+    profiler.prepare(sampleRate, samplesPerBlock);
+#endif
+    updateLatency();
 }
 
 void AudioPluginAudioProcessor::releaseResources()
@@ -129,12 +200,9 @@ bool AudioPluginAudioProcessor::isBusesLayoutSupported(
     juce::ignoreUnused(layouts);
     return true;
 #else
-    // This is the place where you check if the layout is supported.
-    // In this template code we only support mono or stereo.
-    // Some plugin hosts, such as certain GarageBand versions, will only
-    // load plugins that support stereo bus layouts.
-    if (layouts.getMainOutputChannelSet() != juce::AudioChannelSet::mono() &&
-        layouts.getMainOutputChannelSet() != juce::AudioChannelSet::stereo())
+    // Every channel is processed independently, so any layout works, from
+    // mono through 7.1.4 to ambisonic beds
+    if (layouts.getMainOutputChannelSet().isDisabled())
         return false;
 
     // This checks if the input layout matches the output layout
@@ -151,15 +219,44 @@ void AudioPluginAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer,
                                              juce::MidiBuffer& midiMessages)
 {
     juce::ignoreUnused(midiMessages);
+    processSamples(buffer, false);
+}
 
-    juce::ScopedNoDenormals noDenormals;
+void AudioPluginAudioProcessor::processBlock(juce::AudioBuffer<double>& buffer,
+                                             juce::MidiBuffer& midiMessages)
+{
+    juce::ignoreUnused(midiMessages);
+    processSamples(buffer, false);
+}
 
-    currentDrive = *parameters.getRawParameterValue("drive");
-    currentAsymmetry = *parameters.getRawParameterValue("asymmetry");
-    currentSubOctave = *parameters.getRawParameterValue("suboctave");
-    currentDryWet = *parameters.getRawParameterValue("drywet");
-    currentTone = *parameters.getRawParameterValue("tone");
-    currentAlgorithm = static_cast<int>(*parameters.getRawParameterValue("algorithm"));
+void AudioPluginAudioProcessor::processBlockBypassed(juce::AudioBuffer<float>& buffer,
+                                                     juce::MidiBuffer& midiMessages)
+{
+    // The default would pass the input straight through, ahead of the
+    // latency the host is compensating for
+    juce::ignoreUnused(midiMessages);
+    processSamples(buffer, true);
+}
+
+void AudioPluginAudioProcessor::processBlockBypassed(juce::AudioBuffer<double>& buffer,
+                                                     juce::MidiBuffer& midiMessages)
+{
+    juce::ignoreUnused(midiMessages);
+    processSamples(buffer, true);
+}
+
+juce::AudioProcessorParameter* AudioPluginAudioProcessor::getBypassParameter() const
+{
+    return parameters.getParameter("bypass");
+}
+
+template <typename SampleType>
+void AudioPluginAudioProcessor::processSamples(juce::AudioBuffer<SampleType>& buffer,
+                                               bool hostBypassed)
+{
+    juce::ScopedNoDenormals noDenormals;
+    OBLITERATOR_PROFILE_BLOCK(&profiler, buffer.getNumSamples());
+    const auto blockStart = std::chrono::steady_clock::now();
 
     auto totalNumInputChannels = getTotalNumInputChannels();
     auto totalNumOutputChannels = getTotalNumOutputChannels();
@@ -173,140 +270,77 @@ void AudioPluginAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer,
     for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
         buffer.clear(i, 0, buffer.getNumSamples());
 
+    // Continuous parameters ramp inside the engine, so automation moves
+    // smoothly even though they are only read once per block
+    auto& engine = getEngine<SampleType>();
+    auto blockParameters = readParameters();
+    blockParameters.bypassed = blockParameters.bypassed || hostBypassed;
+    engine.setParameters(blockParameters);
 
-    // This is the place where you'd normally do the guts of your plugin's
-    // audio processing...
-    // Make sure to reset the state if your inner loop is processing
-    // the samples and the outer loop is handling the channels.
-    // Alternatively, you can process the samples with the channels
-    // interleaved by keeping the same state.
-    for (int channel = 0; channel < totalNumInputChannels; ++channel)
+    // Left channel for the displays; all no-ops while no editor is reading
+    if (buffer.getNumChannels() > 0)
+        spectrumAnalyzer.captureInput(buffer.getReadPointer(0), buffer.getNumSamples());
+
+    engine.process(buffer.getArrayOfWritePointers(), totalNumInputChannels,
+                   buffer.getNumSamples());
+
+    OBLITERATOR_PROFILE_STAGE(&profiler, DspProfiler::Stage::Analysis);
+
+    // Measured by the engine as it went, so this only stores the results
+    levelMeters.publish(engine, juce::jmin(totalNumInputChannels, buffer.getNumChannels()),
+                        buffer.getNumSamples());
+
+    if (buffer.getNumChannels() > 0)
     {
-        auto *channelData = buffer.getWritePointer(channel);
-        juce::ignoreUnused(channelData);
-        // ..do something to the data...
-        // Apply asymmetric distortion to each sample:
-        for (int sample = 0; sample < buffer.getNumSamples(); ++sample)
-        {
-            float inputSample = channelData[sample];
-            float drySample = inputSample; // Store original dry signal
-            float processedSample;
-
-            // At drive=1.0: pass through unaffected
-            // Above drive=1.0: apply selected distortion algorithm
-            if (currentDrive <= 1.0f)
-            {
-                processedSample = inputSample; // Unity gain, no processing
-            }
-            else
-            {
-                // Apply selected distortion algorithm
-                float distortedSample;
-                switch (static_cast<DistortionType>(currentAlgorithm))
-                {
-                    case DistortionType::Tanh:
-                        distortedSample = applyTanhDistortion(inputSample, currentDrive, currentAsymmetry);
-                        break;
-                    case DistortionType::Foldback:
-                        distortedSample = applyFoldbackDistortion(inputSample, currentDrive, currentAsymmetry);
-                        break;
-                    case DistortionType::Tube:
-                        distortedSample = applyTubeDistortion(inputSample, currentDrive, currentAsymmetry);
-                        break;
-                    default:
-                        distortedSample = inputSample;
-                        break;
-                }
-
-                // Apply DC blocking filter to remove DC offset
-                if (channel < 2)
-                {
-                    auto& dc = dcBlocker[channel];
-                    // DC blocker: y[n] = x[n] - x[n-1] + 0.995 * y[n-1]
-                    processedSample = distortedSample - dc.x1 + 0.995f * dc.y1;
-                    dc.x1 = distortedSample;
-                    dc.y1 = processedSample;
-                }
-                else
-                {
-                    processedSample = distortedSample;
-                }
-            }
-
-            // Sub-octave generation using octave divider
-            float subOctaveSample = 0.0f;
-            if (currentSubOctave > 0.0f && channel < 2)
-            {
-                auto& state = octaveState[channel];
-
-                // Zero-crossing detection with hysteresis
-                bool currentPositive = processedSample > 0.0f;
-
-                // Flip the flip-flop on positive-going zero crossings
-                if (currentPositive && !state.lastPositive)
-                {
-                    state.flipFlop = !state.flipFlop;
-                }
-                state.lastPositive = currentPositive;
-
-                // Generate sub-octave square wave
-                float rawSubOctave = state.flipFlop ? 1.0f : -1.0f;
-
-                // Apply simple lowpass filtering to smooth the square wave
-                float cutoff = 0.1f; // Adjust for smoothness
-                state.lowpassZ1 += cutoff * (rawSubOctave - state.lowpassZ1);
-                // Use independent amplitude so sub-octave is always audible
-                subOctaveSample = state.lowpassZ1 * 0.3f;
-            }
-
-            // Add sub-octave to processed signal
-            float wetSample = processedSample + (subOctaveSample * currentSubOctave);
-
-            // Apply tone filter (tilt EQ)
-            if (channel < 2)
-            {
-                auto& tone = toneState[channel];
-
-                // Tone control: 0.0 = dark, 0.5 = flat, 1.0 = bright
-                // Use simple one-pole lowpass and highpass filters
-
-                // Lowpass for dark tone
-                float lpCutoff = 0.3f;
-                tone.lowpassZ1 += lpCutoff * (wetSample - tone.lowpassZ1);
-
-                // Highpass for bright tone (using difference equation)
-                float hpCutoff = 0.05f;
-                float highpassOut = wetSample - tone.highpassX1 + 0.95f * tone.highpassZ1;
-                tone.highpassZ1 = highpassOut;
-                tone.highpassX1 = wetSample;
-
-                // Mix between lowpass (dark) and highpass (bright) based on tone knob
-                if (currentTone < 0.5f)
-                {
-                    // Blend from full lowpass (0.0) to flat (0.5)
-                    float blend = currentTone * 2.0f; // 0.0 to 1.0
-                    wetSample = tone.lowpassZ1 * (1.0f - blend) + wetSample * blend;
-                }
-                else
-                {
-                    // Blend from flat (0.5) to full highpass (1.0)
-                    float blend = (currentTone - 0.5f) * 2.0f; // 0.0 to 1.0
-                    wetSample = wetSample * (1.0f - blend) + highpassOut * blend;
-                }
-            }
-
-            // Apply dry/wet mixing
-            // currentDryWet = 0.0 (left): 100% dry
-            // currentDryWet = 1.0 (right): 100% wet
-            channelData[sample] = drySample * (1.0f - currentDryWet) + wetSample * currentDryWet;
-        }
+        outputAnalysis.push(buffer.getReadPointer(0), buffer.getNumSamples());
+        spectrumAnalyzer.captureOutput(buffer.getReadPointer(0), buffer.getNumSamples());
     }
 
-    // Send output to oscilloscope (use left channel for mono display)
-    if (oscilloscopeComponent != nullptr && buffer.getNumChannels() > 0)
+    const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - blockStart;
+    publishLoad<SampleType>(elapsed.count(), buffer.getNumSamples(), blockParameters);
+}
+
+template <typename SampleType>
+void AudioPluginAudioProcessor::publishLoad(double processingNs, int numSamples,
+                                            const DistortionParameters& blockParameters)
+{
+    if (loadSlot == nullptr || getSampleRate() <= 0.0)
+        return;
+
+    auto state = InstanceLoadTable::State::Processing;
+    switch (getEngine<SampleType>().getProcessingState())
     {
-        oscilloscopeComponent->pushBuffer(buffer.getReadPointer(0), buffer.getNumSamples());
+        case DistortionEngine<SampleType>::ProcessingState::Processing: state = InstanceLoadTable::State::Processing; break;
+        case DistortionEngine<SampleType>::ProcessingState::Idle:       state = InstanceLoadTable::State::Idle; break;
+        case DistortionEngine<SampleType>::ProcessingState::Bypassed:   state = InstanceLoadTable::State::Bypassed; break;
     }
+
+    loadSlot->update(processingNs, 1.0e9 * numSamples / getSampleRate(),
+                     static_cast<int>(blockParameters.algorithm), 1 << blockParameters.oversamplingOrder, state);
+}
+
+DistortionParameters AudioPluginAudioProcessor::readParameters() const
+{
+    const auto load = [](const std::atomic<float>* value)
+    {
+        return value->load(std::memory_order_relaxed);
+    };
+
+    DistortionParameters snapshot;
+    snapshot.drive = load(parameterPointers.drive);
+    snapshot.asymmetry = load(parameterPointers.asymmetry);
+    snapshot.subOctave = load(parameterPointers.subOctave);
+    snapshot.dryWet = load(parameterPointers.dryWet);
+    snapshot.tone = load(parameterPointers.tone);
+    snapshot.foldDepth = load(parameterPointers.foldDepth);
+    snapshot.algorithm = static_cast<DistortionType>(static_cast<int>(load(parameterPointers.algorithm)));
+    snapshot.precision = static_cast<MathPrecision>(static_cast<int>(load(parameterPointers.precision)));
+    snapshot.antialiasing = static_cast<AntialiasingMode>(static_cast<int>(load(parameterPointers.antialiasing)));
+    snapshot.oversamplingOrder = static_cast<int>(load(parameterPointers.oversampling));
+    snapshot.oversamplingPhase = static_cast<OversamplingPhase>(
+            static_cast<int>(load(parameterPointers.oversamplingPhase)));
+    snapshot.bypassed = load(parameterPointers.bypass) >= 0.5f;
+    return snapshot;
 }
 
 //==============================================================================
@@ -328,6 +362,12 @@ void AudioPluginAudioProcessor::getStateInformation(juce::MemoryBlock& destData)
     copyXmlToBinary(*xml, destData);
 }
 
+void AudioPluginAudioProcessor::updateTrackProperties(const TrackProperties& properties)
+{
+    if (loadSlot != nullptr && properties.name.has_value())
+        loadSlot->setName(properties.name->toStdString());
+}
+
 void AudioPluginAudioProcessor::setStateInformation(const void *data,
                                                     int sizeInBytes)
 {
@@ -339,76 +379,27 @@ void AudioPluginAudioProcessor::setStateInformation(const void *data,
 }
 
 //==============================================================================
-void AudioPluginAudioProcessor::setOscilloscopeComponent(OscilloscopeComponent* osc)
+void AudioPluginAudioProcessor::parameterChanged(const juce::String& parameterID,
+                                                 float newValue)
 {
-    oscilloscopeComponent = osc;
+    juce::ignoreUnused(parameterID, newValue);
+    updateLatency();
 }
 
-//==============================================================================
-// Distortion algorithm implementations
-float AudioPluginAudioProcessor::applyTanhDistortion(float input, float drive, float asymmetry)
+void AudioPluginAudioProcessor::updateLatency()
 {
-    // Apply asymmetric bias before distortion
-    float biasedInput = input + asymmetry * 0.5f;
-    return std::tanh(drive * biasedInput);
-}
-
-float AudioPluginAudioProcessor::applyFoldbackDistortion(float input, float drive, float asymmetry)
-{
-    // Wave folding algorithm
-    // Scale input by drive amount (use moderate scaling)
-    float scaledInput = input * std::sqrt(drive);
-
-    // Asymmetric folding: adjust thresholds based on asymmetry parameter
-    // Positive asymmetry = higher positive threshold, lower negative threshold
-    // Negative asymmetry = lower positive threshold, higher negative threshold
-    float positiveThreshold = 1.0f + asymmetry * 0.5f;
-    float negativeThreshold = 1.0f - asymmetry * 0.5f;
-
-    // Apply asymmetric wave folding with reflection
-    float foldedSample = scaledInput;
-    int maxIterations = 20; // Prevent infinite loops
-    for (int i = 0; i < maxIterations; ++i)
-    {
-        if (foldedSample > positiveThreshold)
-            foldedSample = 2.0f * positiveThreshold - foldedSample;
-        else if (foldedSample < -negativeThreshold)
-            foldedSample = -2.0f * negativeThreshold - foldedSample;
-        else
-            break; // No more folding needed
-    }
-
-    // Simple output scaling to maintain reasonable levels
-    return foldedSample * 0.8f;
-}
-
-float AudioPluginAudioProcessor::applyTubeDistortion(float input, float drive, float asymmetry)
-{
-    // Apply asymmetric bias before distortion
-    float biasedInput = input + asymmetry * 0.5f;
-
-    // Scale input by drive amount with high sensitivity for extreme saturation
-    // Use sqrt to match the intensity curve, with aggressive multiplier
-    float scaledInput = biasedInput * std::sqrt(drive) * 5.0f;
-
-    // Tube distortion using exponential saturation
-    // Positive and negative sides have different characteristics (asymmetric)
-    float output;
-    if (scaledInput >= 0.0f)
-    {
-        // Positive side: softer compression
-        output = 1.0f - std::exp(-scaledInput);
-    }
-    else
-    {
-        // Negative side: slightly harder compression (tube characteristic)
-        output = -1.0f + std::exp(scaledInput * 1.2f);
-    }
-
-    // Apply gentle compression to tame peaks
-    output = output * 0.85f;
-
-    return output;
+    // The engine knows the latency of every setting once it is prepared, so
+    // this is safe to call whenever the oversampling parameters move
+    const int order = static_cast<int>(parameterPointers.oversampling->load());
+    const auto phase = static_cast<OversamplingPhase>(
+            static_cast<int>(parameterPointers.oversamplingPhase->load()));
+
+    const int latency = isUsingDoublePrecision() ? doubleEngine.getLatencySamples(order, phase)
+                                                 : floatEngine.getLatencySamples(order, phase);
+    if (latency != getLatencySamples())
+        setLatencySamples(latency);
+
+    spectrumAnalyzer.setInputDelay(latency);
 }
 
 //==============================================================================
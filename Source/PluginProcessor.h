@@ -1,21 +1,15 @@
 #pragma once
 
 #include <juce_audio_processors/juce_audio_processors.h>
-
-// Forward declaration
-class OscilloscopeComponent;
-
-//==============================================================================
-// Distortion algorithm types
-enum class DistortionType
-{
-    Tanh = 0,
-    Foldback = 1,
-    Tube = 2
-};
+#include "DSP/AnalysisRing.h"
+#include "DSP/DistortionEngine.h"
+#include "InstanceLoadTable.h"
+#include "LevelMeters.h"
+#include "SpectrumAnalyzer.h"
 
 //==============================================================================
-class AudioPluginAudioProcessor final : public juce::AudioProcessor
+class AudioPluginAudioProcessor final : public juce::AudioProcessor,
+                                        private juce::AudioProcessorValueTreeState::Listener
 {
 public:
     //==============================================================================
@@ -30,8 +24,16 @@ public:
 
     bool isBusesLayoutSupported(const BusesLayout& layouts) const override;
 
+    // Both precisions run natively, so 64-bit hosts skip the conversion
+    bool supportsDoublePrecisionProcessing() const override { return true; }
     void processBlock(juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
-    using AudioProcessor::processBlock;
+    void processBlock(juce::AudioBuffer<double>&, juce::MidiBuffer&) override;
+
+    // Host bypass: the same latency-compensated crossfade as the bypass
+    // parameter, which is what hosts that support one will drive instead
+    void processBlockBypassed(juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
+    void processBlockBypassed(juce::AudioBuffer<double>&, juce::MidiBuffer&) override;
+    juce::AudioProcessorParameter* getBypassParameter() const override;
 
     //==============================================================================
     juce::AudioProcessorEditor *createEditor() override;
@@ -56,58 +58,83 @@ public:
     void getStateInformation (juce::MemoryBlock& destData) override;
     void setStateInformation (const void* data, int sizeInBytes) override;
 
-    //==============================================================================
-    // Oscilloscope support
-    void setOscilloscopeComponent(OscilloscopeComponent* osc);
+    // Names this instance after its track in the load table
+    void updateTrackProperties(const TrackProperties& properties) override;
 
-private:
-    juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout();
+    //==============================================================================
+    // Decimated output for the editor's displays. It lives as long as the
+    // processor, so editors can come and go while audio runs.
+    AnalysisRing& getOutputAnalysis() { return outputAnalysis; }
+    SpectrumAnalyzer& getSpectrumAnalyzer() { return spectrumAnalyzer; }
+    LevelMeters& getLevelMeters() { return levelMeters; }
 
+    // Id of this instance's row in InstanceLoadTable, or 0 if it has none
+    int getLoadSlotId() const { return loadSlot != nullptr ? loadSlot->getId() : 0; }
 
-    juce::AudioParameterFloat *driveParameter;
-    juce::AudioParameterFloat *asymmetryParameter;
-    juce::AudioParameterFloat *subOctaveParameter;
-    juce::AudioParameterFloat *dryWetParameter;
-    juce::AudioParameterFloat *toneParameter;
-    // DSP State:
-    float currentDrive = 1.0f;
-    float currentAsymmetry = 0.0f;
-    float currentSubOctave = 0.0f;
-    float currentDryWet = 1.0f;
-    float currentTone = 0.5f;
-    int currentAlgorithm = 0;
-
-    // Distortion processing methods
-    float applyTanhDistortion(float input, float drive, float asymmetry);
-    float applyFoldbackDistortion(float input, float drive, float asymmetry);
-    float applyTubeDistortion(float input, float drive, float asymmetry);
-
-    // Octave divider state (per channel)
-    struct OctaveDividerState {
-        bool lastPositive = false;
-        bool flipFlop = false;
-        float subOscillator = 0.0f;
-        float lowpassZ1 = 0.0f; // For smoothing the sub-octave
-    };
-    OctaveDividerState octaveState[2]; // Left and right channel
+#if OBLITERATOR_PROFILING
+    // Stage timings and the block deadline, for the editor's debug overlay
+    DspProfiler& getProfiler() { return profiler; }
+#endif
 
-    // DC blocking filter state (per channel)
-    struct DCBlockerState {
-        float x1 = 0.0f;
-        float y1 = 0.0f;
-    };
-    DCBlockerState dcBlocker[2];
+private:
+    juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout();
 
-    // Tone filter state (per channel)
-    struct ToneFilterState {
-        float lowpassZ1 = 0.0f;
-        float highpassZ1 = 0.0f;
-        float highpassX1 = 0.0f;
+    // Keeps the reported latency in sync with the oversampling settings
+    void parameterChanged(const juce::String& parameterID, float newValue) override;
+    void updateLatency();
+
+    // Raw parameter values, looked up once in the constructor so the audio
+    // thread never searches the APVTS by ID
+    struct ParameterPointers
+    {
+        std::atomic<float>* drive = nullptr;
+        std::atomic<float>* asymmetry = nullptr;
+        std::atomic<float>* subOctave = nullptr;
+        std::atomic<float>* dryWet = nullptr;
+        std::atomic<float>* tone = nullptr;
+        std::atomic<float>* foldDepth = nullptr;
+        std::atomic<float>* algorithm = nullptr;
+        std::atomic<float>* precision = nullptr;
+        std::atomic<float>* antialiasing = nullptr;
+        std::atomic<float>* oversampling = nullptr;
+        std::atomic<float>* oversamplingPhase = nullptr;
+        std::atomic<float>* bypass = nullptr;
     };
-    ToneFilterState toneState[2];
-
-    // Oscilloscope
-    OscilloscopeComponent* oscilloscopeComponent = nullptr;
+    ParameterPointers parameterPointers;
+
+    // Reads every parameter once into a snapshot for the current block
+    DistortionParameters readParameters() const;
+
+    // Shared body of the processBlock and processBlockBypassed overloads
+    template <typename SampleType>
+    void processSamples(juce::AudioBuffer<SampleType>& buffer, bool hostBypassed);
+
+    // DSP chain (drive -> DC blocker -> sub-octave -> tone -> mix), one per
+    // sample type. Only the one matching the host's precision is prepared.
+    DistortionEngine<float> floatEngine;
+    DistortionEngine<double> doubleEngine;
+
+    template <typename SampleType>
+    DistortionEngine<SampleType>& getEngine()
+    {
+        if constexpr (std::is_same_v<SampleType, double>)
+            return doubleEngine;
+        else
+            return floatEngine;
+    }
+
+    AnalysisRing outputAnalysis;
+    SpectrumAnalyzer spectrumAnalyzer;
+    LevelMeters levelMeters;
+
+    // This instance's row in the process-wide load table; nullptr if full
+    InstanceLoadTable::Slot* loadSlot = nullptr;
+    template <typename SampleType>
+    void publishLoad(double processingNs, int numSamples, const DistortionParameters& blockParameters);
+
+#if OBLITERATOR_PROFILING
+    DspProfiler profiler;
+#endif
 
     //==============================================================================
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AudioPluginAudioProcessor)
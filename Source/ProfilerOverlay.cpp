@@ -0,0 +1,96 @@
+#include "ProfilerOverlay.h"
+
+#if OBLITERATOR_PROFILING
+
+ProfilerOverlay::ProfilerOverlay(DspProfiler& source)
+    : profiler(source)
+{
+    resetButton.onClick = [this]() { profiler.requestReset(); };
+    exportButton.onClick = [this]() { exportTrace(); };
+    addAndMakeVisible(resetButton);
+    addAndMakeVisible(exportButton);
+}
+
+void ProfilerOverlay::visibilityChanged()
+{
+    // Text only needs refreshing a few times a second, and not at all while
+    // hidden
+    if (isVisible())
+        startTimerHz(4);
+    else
+        stopTimer();
+}
+
+void ProfilerOverlay::timerCallback()
+{
+    repaint();
+}
+
+void ProfilerOverlay::resized()
+{
+    auto buttons = getLocalBounds().reduced(8).removeFromBottom(22);
+    exportButton.setBounds(buttons.removeFromRight(100));
+    buttons.removeFromRight(6);
+    resetButton.setBounds(buttons.removeFromRight(60));
+}
+
+void ProfilerOverlay::paint(juce::Graphics& g)
+{
+    g.setColour(juce::Colours::black.withAlpha(0.85f));
+    g.fillRoundedRectangle(getLocalBounds().toFloat(), 14.0f);
+
+    auto area = getLocalBounds().reduced(12, 10);
+    const int rowHeight = 16;
+    g.setFont(juce::FontOptions(juce::Font::getDefaultMonospacedFontName(), 12.0f, juce::Font::plain));
+
+    const auto micros = [](double ns) { return juce::String(ns * 0.001, 1); };
+    const auto row = [&](const juce::String& text, juce::Colour colour)
+    {
+        g.setColour(colour);
+        g.drawText(text, area.removeFromTop(rowHeight), juce::Justification::centredLeft, false);
+    };
+
+    const auto block = profiler.getBlockStatistics();
+    const bool overran = block.overruns > 0;
+    row("Deadline " + micros(block.deadlineNs) + " us, worst block " + micros(block.worstNs) + " us",
+        overran ? juce::Colours::red : juce::Colour(0xffD4B870));
+    row("Worst load " + juce::String(block.worstLoad * 100.0, 1) + "%, "
+            + juce::String((juce::int64) block.overruns) + " of " + juce::String((juce::int64) block.blocks)
+            + " blocks over",
+        overran ? juce::Colours::red : juce::Colour(0xffD4B870));
+    area.removeFromTop(6);
+
+    row(juce::String("Stage (us)").paddedRight(' ', 12) + "   mean    p50    p99    max",
+        juce::Colours::grey);
+
+    for (int stage = 0; stage < DspProfiler::numStages; ++stage)
+    {
+        const auto stats = profiler.getStatistics(static_cast<DspProfiler::Stage>(stage));
+        const auto column = [&](double ns) { return micros(ns).paddedLeft(' ', 7); };
+        row(juce::String(DspProfiler::getStageName(static_cast<DspProfiler::Stage>(stage))).paddedRight(' ', 12)
+                + column(stats.meanNs) + column(stats.p50Ns) + column(stats.p99Ns) + column(stats.maxNs),
+            juce::Colours::white);
+    }
+}
+
+void ProfilerOverlay::exportTrace()
+{
+    fileChooser = std::make_unique<juce::FileChooser>(
+            "Save DSP trace",
+            juce::File::getSpecialLocation(juce::File::userDesktopDirectory).getChildFile("obliterator-trace.json"),
+            "*.json");
+
+    // Captured now, so the file shows the moment the button was pressed
+    const auto trace = juce::String(profiler.createChromeTrace());
+
+    fileChooser->launchAsync(juce::FileBrowserComponent::saveMode | juce::FileBrowserComponent::canSelectFiles
+                                 | juce::FileBrowserComponent::warnAboutOverwriting,
+                             [trace](const juce::FileChooser& chooser)
+                             {
+                                 const auto file = chooser.getResult();
+                                 if (file != juce::File())
+                                     file.replaceWithText(trace);
+                             });
+}
+
+#endif
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <juce_gui_basics/juce_gui_basics.h>
+#include "DSP/DspProfiler.h"
+
+#if OBLITERATOR_PROFILING
+
+// Debug overlay for the processor's DspProfiler: per-stage mean, median,
+// 99th percentile and worst time, the worst block against the host's
+// deadline, and a button that saves the recent stage events as a Chrome
+// trace. Only exists in builds with OBLITERATOR_PROFILING.
+class ProfilerOverlay : public juce::Component,
+                        private juce::Timer
+{
+public:
+    explicit ProfilerOverlay(DspProfiler& source);
+
+    void paint(juce::Graphics& g) override;
+    void resized() override;
+    void visibilityChanged() override;
+
+private:
+    void timerCallback() override;
+    void exportTrace();
+
+    DspProfiler& profiler;
+    juce::TextButton resetButton { "Reset" };
+    juce::TextButton exportButton { "Export trace" };
+    std::unique_ptr<juce::FileChooser> fileChooser;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ProfilerOverlay)
+};
+
+#endif
@@ -0,0 +1,157 @@
+#include "ScopeHistory.h"
+#include <algorithm>
+#include <cmath>
+
+ScopeHistory::ScopeHistory()
+{
+    for (auto& level : levels)
+        level.entries.resize(levelSize);
+}
+
+void ScopeHistory::clear()
+{
+    for (auto& level : levels)
+    {
+        level.written = 0;
+        level.pendingCount = 0;
+    }
+}
+
+uint64_t ScopeHistory::factorOf(int level)
+{
+    uint64_t factor = 1;
+    for (int i = 0; i < level; ++i)
+        factor *= levelFactor;
+    return factor;
+}
+
+void ScopeHistory::append(const MinMax* pairs, int numPairs)
+{
+    for (int i = 0; i < numPairs; ++i)
+        push(0, pairs[i]);
+}
+
+void ScopeHistory::push(int levelIndex, MinMax entry)
+{
+    auto& level = levels[static_cast<size_t>(levelIndex)];
+    level.entries[level.written++ & mask] = entry;
+
+    if (levelIndex + 1 == numLevels)
+        return;
+
+    // Merge into the next level up, and hand it on once complete
+    auto& parent = levels[static_cast<size_t>(levelIndex + 1)];
+    if (parent.pendingCount == 0)
+    {
+        parent.pending = entry;
+    }
+    else
+    {
+        parent.pending.min = std::min(parent.pending.min, entry.min);
+        parent.pending.max = std::max(parent.pending.max, entry.max);
+    }
+
+    if (++parent.pendingCount == levelFactor)
+    {
+        parent.pendingCount = 0;
+        push(levelIndex + 1, parent.pending);
+    }
+}
+
+uint64_t ScopeHistory::getOldestPosition() const
+{
+    // The coarsest level always reaches furthest back
+    const auto& top = levels[numLevels - 1];
+    const auto oldestEntry = top.written > static_cast<uint64_t>(levelSize) ? top.written - levelSize : 0;
+    return oldestEntry * factorOf(numLevels - 1);
+}
+
+int ScopeHistory::chooseLevel(double pairsPerColumn, double start) const
+{
+    // Coarsest level with at least one entry per column, then coarser still
+    // if that one has already dropped the start of the window
+    int level = 0;
+    while (level + 1 < numLevels && static_cast<double>(factorOf(level + 1)) <= pairsPerColumn)
+        ++level;
+
+    for (; level < numLevels; ++level)
+    {
+        const auto& entries = levels[static_cast<size_t>(level)];
+        const auto oldestEntry = entries.written > static_cast<uint64_t>(levelSize) ? entries.written - levelSize : 0;
+        if (start >= static_cast<double>(oldestEntry * factorOf(level)))
+            return level;
+    }
+
+    return -1;
+}
+
+bool ScopeHistory::render(double start, double length, MinMax* columns, int numColumns) const
+{
+    if (numColumns <= 0 || length <= 0.0)
+        return false;
+
+    const double pairsPerColumn = length / numColumns;
+    const int levelIndex = chooseLevel(pairsPerColumn, std::max(0.0, start));
+    if (levelIndex < 0)
+        return false;
+
+    const auto& level = levels[static_cast<size_t>(levelIndex)];
+    const double factor = static_cast<double>(factorOf(levelIndex));
+
+    for (int column = 0; column < numColumns; ++column)
+    {
+        // Entries overlapping this column, at least one of them
+        const double columnStart = (start + column * pairsPerColumn) / factor;
+        const double columnEnd = (start + (column + 1) * pairsPerColumn) / factor;
+        const auto first = static_cast<int64_t>(std::floor(columnStart));
+        const auto last = std::max(first + 1, static_cast<int64_t>(std::ceil(columnEnd)));
+
+        MinMax range { 0.0f, 0.0f };
+        bool found = false;
+
+        for (auto i = first; i < last; ++i)
+        {
+            // Before the first pair or not yet written: silence
+            if (i < 0 || static_cast<uint64_t>(i) >= level.written)
+                continue;
+
+            const auto& entry = level.entries[static_cast<uint64_t>(i) & mask];
+            range.min = found ? std::min(range.min, entry.min) : entry.min;
+            range.max = found ? std::max(range.max, entry.max) : entry.max;
+            found = true;
+        }
+
+        columns[column] = range;
+    }
+
+    return true;
+}
+
+int64_t ScopeHistory::findRisingEdge(uint64_t from, uint64_t to, float level, double pairsPerColumn) const
+{
+    const int levelIndex = chooseLevel(pairsPerColumn, static_cast<double>(from));
+    if (levelIndex < 0)
+        return -1;
+
+    const auto& entries = levels[static_cast<size_t>(levelIndex)];
+    const auto factor = factorOf(levelIndex);
+
+    // Compare entry midpoints, which are the samples themselves at level 0
+    // when no decimation is needed
+    const auto midpoint = [&entries](uint64_t i)
+    {
+        const auto& entry = entries.entries[i & mask];
+        return 0.5f * (entry.min + entry.max);
+    };
+
+    const auto oldestEntry = entries.written > static_cast<uint64_t>(levelSize) ? entries.written - levelSize : 0;
+    // Rounded up, so the edge returned is never before from
+    const auto first = std::max<uint64_t>((from + factor - 1) / factor, oldestEntry + 1);
+    const auto last = std::min(to / factor, entries.written);
+
+    for (auto i = first; i < last; ++i)
+        if (midpoint(i - 1) < level && midpoint(i) >= level)
+            return static_cast<int64_t>(i * factor);
+
+    return -1;
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <vector>
+#include "DSP/AnalysisRing.h"
+
+//==============================================================================
+// Long min/max history for the oscilloscope, kept at several resolutions.
+// Level 0 holds the pairs as they come out of the AnalysisRing, and every
+// further level merges levelFactor entries of the one below, so each level
+// covers levelFactor times the time span in the same memory. Drawing a
+// window picks the coarsest level that still has at least one entry per
+// pixel column, so any timebase costs about the same to render.
+//
+// Positions are absolute level 0 pair counts since the last clear(), so
+// trigger points stay valid as the history scrolls. Message thread only.
+class ScopeHistory
+{
+public:
+    using MinMax = AnalysisRing::MinMax;
+
+    static constexpr int numLevels = 4;
+    static constexpr int levelFactor = 4;
+    static constexpr int levelSize = 1 << 13; // About 0.34 s at level 0, 22 s at level 3
+
+    ScopeHistory();
+
+    void clear();
+    void append(const MinMax* pairs, int numPairs);
+
+    // Level 0 pairs appended since clear(), i.e. the position just past the newest
+    uint64_t getEndPosition() const { return levels[0].written; }
+
+    // Oldest position still held, at the coarsest level
+    uint64_t getOldestPosition() const;
+
+    // Reduces [start, start + length) to numColumns min/max pairs. Returns
+    // false, leaving columns untouched, when that span is no longer held.
+    bool render(double start, double length, MinMax* columns, int numColumns) const;
+
+    // Earliest rising crossing of the level in [from, to), found at the
+    // resolution render() would use for pairsPerColumn. Returns -1 if none.
+    int64_t findRisingEdge(uint64_t from, uint64_t to, float level, double pairsPerColumn) const;
+
+private:
+    struct Level
+    {
+        std::vector<MinMax> entries;
+        uint64_t written = 0;  // Entries completed at this level
+        MinMax pending {};     // Merge of the entries below, not yet complete
+        int pendingCount = 0;
+    };
+
+    std::array<Level, numLevels> levels;
+
+    static constexpr uint64_t mask = levelSize - 1;
+    static uint64_t factorOf(int level);
+    int chooseLevel(double pairsPerColumn, double start) const;
+    void push(int level, MinMax entry);
+};
@@ -0,0 +1,157 @@
+#include "SpectrumAnalyzer.h"
+
+SpectrumAnalyzer::SpectrumAnalyzer()
+    : juce::Thread("Obliterator spectrum")
+{
+    for (auto& signal : history)
+        signal.assign(static_cast<size_t>(historySize), 0.0f);
+    for (auto& power : averagedPower)
+        power.assign(static_cast<size_t>(fftSize / 2 + 1), 0.0f);
+    fftData.assign(static_cast<size_t>(2 * fftSize), 0.0f);
+}
+
+SpectrumAnalyzer::~SpectrumAnalyzer()
+{
+    stopThread(1000);
+}
+
+void SpectrumAnalyzer::prepare(double sampleRate)
+{
+    currentSampleRate.store(sampleRate);
+}
+
+void SpectrumAnalyzer::addClient()
+{
+    if (numClients++ == 0)
+    {
+        // Whatever is left from the last attach is stale. The analysis
+        // thread is stopped, so this is the only reader.
+        fifo.finishedRead(fifo.getNumReady());
+        for (auto& signal : history)
+            std::fill(signal.begin(), signal.end(), 0.0f);
+        for (auto& power : averagedPower)
+            std::fill(power.begin(), power.end(), 0.0f);
+        historyPosition = 0;
+        std::atomic_store(&snapshot, std::shared_ptr<const Snapshot>());
+
+        active.store(true);
+        startThread(juce::Thread::Priority::low);
+    }
+}
+
+void SpectrumAnalyzer::removeClient()
+{
+    jassert(numClients > 0);
+
+    if (--numClients == 0)
+    {
+        active.store(false);
+        stopThread(1000);
+    }
+}
+
+void SpectrumAnalyzer::run()
+{
+    while (! threadShouldExit())
+    {
+        // Nothing new, e.g. with the transport stopped: keep the last spectra
+        if (drainFifo() > 0)
+            analyse();
+
+        wait(33);
+    }
+}
+
+int SpectrumAnalyzer::drainFifo()
+{
+    // Keep only the newest historySize samples of each signal
+    const auto scope = fifo.read(fifo.getNumReady());
+
+    const auto append = [this](int start, int size)
+    {
+        for (int i = 0; i < size; ++i)
+        {
+            history[0][static_cast<size_t>(historyPosition)] = fifoBuffer.getSample(0, start + i);
+            history[1][static_cast<size_t>(historyPosition)] = fifoBuffer.getSample(1, start + i);
+            historyPosition = (historyPosition + 1) % historySize;
+        }
+    };
+
+    append(scope.startIndex1, scope.blockSize1);
+    append(scope.startIndex2, scope.blockSize2);
+    return scope.blockSize1 + scope.blockSize2;
+}
+
+void SpectrumAnalyzer::updateBinMapping(double sampleRate)
+{
+    mappedSampleRate = sampleRate;
+    const double binWidth = sampleRate / fftSize;
+    const double maxFrequency = juce::jmin(20000.0, 0.5 * sampleRate);
+
+    // Each display bin takes the strongest FFT bin between the geometric
+    // midpoints to its neighbours, or the nearest one where the display is
+    // finer than the FFT
+    for (int bin = 0; bin < numBins; ++bin)
+    {
+        const auto edge = [&](double position)
+        {
+            return 20.0 * std::pow(maxFrequency / 20.0, position / (numBins - 1)) / binWidth;
+        };
+
+        const int lowest = juce::jlimit(1, fftSize / 2, static_cast<int>(std::ceil(edge(bin - 0.5))));
+        const int highest = juce::jlimit(1, fftSize / 2, static_cast<int>(std::floor(edge(bin + 0.5))));
+        const int nearest = juce::jlimit(1, fftSize / 2, static_cast<int>(std::lround(edge(bin))));
+
+        firstFftBin[static_cast<size_t>(bin)] = highest >= lowest ? lowest : nearest;
+        lastFftBin[static_cast<size_t>(bin)] = highest >= lowest ? highest : nearest;
+    }
+}
+
+void SpectrumAnalyzer::analyse()
+{
+    const double sampleRate = currentSampleRate.load();
+    if (sampleRate != mappedSampleRate)
+        updateBinMapping(sampleRate);
+
+    auto next = std::make_shared<Snapshot>();
+    next->maxFrequency = static_cast<float>(juce::jmin(20000.0, 0.5 * sampleRate));
+
+    // Hann coherent gain is 0.5, so a full-scale sine peaks at N / 4
+    const float normalisation = 4.0f / static_cast<float>(fftSize);
+    constexpr float smoothing = 0.6f; // Weight of the previous average
+
+    for (size_t signal = 0; signal < 2; ++signal)
+    {
+        // Oldest sample first. The input window ends inputDelay samples
+        // before the newest, where the newest output sample started out.
+        const auto& samples = history[signal];
+        const int delay = signal == 0 ? inputDelay.load() : 0;
+        const int start = (historyPosition + historySize - fftSize - delay) % historySize;
+        for (int i = 0; i < fftSize; ++i)
+            fftData[static_cast<size_t>(i)] = samples[static_cast<size_t>((start + i) % historySize)];
+        std::fill(fftData.begin() + fftSize, fftData.end(), 0.0f);
+
+        window.multiplyWithWindowingTable(fftData.data(), static_cast<size_t>(fftSize));
+        fft.performFrequencyOnlyForwardTransform(fftData.data(), true);
+
+        auto& power = averagedPower[signal];
+        for (int k = 0; k <= fftSize / 2; ++k)
+        {
+            const float magnitude = fftData[static_cast<size_t>(k)] * normalisation;
+            power[static_cast<size_t>(k)] = smoothing * power[static_cast<size_t>(k)]
+                                          + (1.0f - smoothing) * magnitude * magnitude;
+        }
+
+        auto& levels = signal == 0 ? next->inputDb : next->outputDb;
+        for (int bin = 0; bin < numBins; ++bin)
+        {
+            float strongest = 0.0f;
+            for (int k = firstFftBin[static_cast<size_t>(bin)]; k <= lastFftBin[static_cast<size_t>(bin)]; ++k)
+                strongest = juce::jmax(strongest, power[static_cast<size_t>(k)]);
+
+            levels[static_cast<size_t>(bin)] = 10.0f * std::log10(strongest + 1.0e-12f);
+        }
+    }
+
+    std::atomic_store(&snapshot, std::shared_ptr<const Snapshot>(std::move(next)));
+}
@@ -0,0 +1,140 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <juce_dsp/juce_dsp.h>
+#include <array>
+#include <atomic>
+#include <memory>
+
+//==============================================================================
+// Input and output spectra for the editor, computed off the audio thread.
+//
+// The audio thread only copies the first channel of each block, before and
+// after processing, into a lock-free FIFO. The copy is at the full sample
+// rate: the view exists to show aliasing and the top-octave content the
+// waveshapers add, which decimating would fold or filter away. The output
+// lags the input by the engine latency, so the input window is taken that
+// many samples further back. A background thread drains the FIFO
+// about 30 times a second, runs a Hann-windowed FFT over the newest
+// fftSize samples of each signal, averages the power over time, bins it on
+// a log frequency axis and publishes the result as an immutable Snapshot.
+//
+// The thread only runs while at least one display is attached; with none,
+// the capture calls return straight away.
+class SpectrumAnalyzer : private juce::Thread
+{
+public:
+    static constexpr int fftOrder = 12;
+    static constexpr int fftSize = 1 << fftOrder;
+    static constexpr int numBins = 256;
+    static constexpr int maxInputDelay = fftSize;
+
+    struct Snapshot
+    {
+        float minFrequency = 20.0f;
+        float maxFrequency = 20000.0f;
+        std::array<float, numBins> inputDb {};  // Full-scale sine = 0 dB
+        std::array<float, numBins> outputDb {};
+
+        // Centre frequency of a bin, log-spaced between the limits
+        float getBinFrequency(int bin) const
+        {
+            return minFrequency * std::pow(maxFrequency / minFrequency, static_cast<float>(bin) / static_cast<float>(numBins - 1));
+        }
+    };
+
+    SpectrumAnalyzer();
+    ~SpectrumAnalyzer() override;
+
+    // Called while the audio thread is stopped
+    void prepare(double sampleRate);
+
+    // Engine latency in samples, so the input and output windows line up.
+    // Any thread; up to maxInputDelay.
+    void setInputDelay(int numSamples) { inputDelay.store(juce::jlimit(0, maxInputDelay, numSamples)); }
+
+    //==============================================================================
+    // Audio thread: the input before processing, then the output of the
+    // same block. Wait-free; samples that don't fit are dropped.
+    template <typename SampleType>
+    void captureInput(const SampleType* data, int numSamples);
+
+    template <typename SampleType>
+    void captureOutput(const SampleType* data, int numSamples);
+
+    //==============================================================================
+    // Message thread. Displays attach for as long as they are visible.
+    void addClient();
+    void removeClient();
+
+    // The newest spectra, or nullptr before the first FFT
+    std::shared_ptr<const Snapshot> getSnapshot() const { return std::atomic_load(&snapshot); }
+
+private:
+    void run() override;
+    int drainFifo();
+    void analyse();
+    void updateBinMapping(double sampleRate);
+
+    // Audio thread side
+    static constexpr int fifoSize = 1 << 15;
+    juce::AbstractFifo fifo { fifoSize };
+    juce::AudioBuffer<float> fifoBuffer { 2, fifoSize };
+    std::atomic<bool> active { false };
+    int blockStart1 = 0, blockSize1 = 0, blockStart2 = 0, blockSize2 = 0;
+    std::atomic<double> currentSampleRate { 44100.0 };
+    std::atomic<int> inputDelay { 0 };
+
+    // Analysis thread side
+    juce::dsp::FFT fft { fftOrder };
+    juce::dsp::WindowingFunction<float> window { static_cast<size_t>(fftSize),
+                                                 juce::dsp::WindowingFunction<float>::hann, false };
+    static constexpr int historySize = fftSize + maxInputDelay;
+    std::array<std::vector<float>, 2> history;  // Newest historySize samples per signal
+    int historyPosition = 0;
+    std::vector<float> fftData;
+    std::array<std::vector<float>, 2> averagedPower;
+    double mappedSampleRate = 0.0;
+    std::array<int, numBins> firstFftBin {}, lastFftBin {};
+
+    int numClients = 0;
+    std::shared_ptr<const Snapshot> snapshot;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SpectrumAnalyzer)
+};
+
+//==============================================================================
+template <typename SampleType>
+void SpectrumAnalyzer::captureInput(const SampleType* data, int numSamples)
+{
+    blockSize1 = blockSize2 = 0;
+    if (! active.load(std::memory_order_relaxed))
+        return;
+
+    fifo.prepareToWrite(numSamples, blockStart1, blockSize1, blockStart2, blockSize2);
+
+    auto* destination = fifoBuffer.getWritePointer(0);
+    for (int i = 0; i < blockSize1; ++i)
+        destination[blockStart1 + i] = static_cast<float>(data[i]);
+    for (int i = 0; i < blockSize2; ++i)
+        destination[blockStart2 + i] = static_cast<float>(data[blockSize1 + i]);
+}
+
+template <typename SampleType>
+void SpectrumAnalyzer::captureOutput(const SampleType* data, int numSamples)
+{
+    // Same region as the input, which is only handed over now
+    if (blockSize1 + blockSize2 == 0)
+        return;
+
+    jassert(blockSize1 + blockSize2 <= numSamples);
+    juce::ignoreUnused(numSamples);
+
+    auto* destination = fifoBuffer.getWritePointer(1);
+    for (int i = 0; i < blockSize1; ++i)
+        destination[blockStart1 + i] = static_cast<float>(data[i]);
+    for (int i = 0; i < blockSize2; ++i)
+        destination[blockStart2 + i] = static_cast<float>(data[blockSize1 + i]);
+
+    fifo.finishedWrite(blockSize1 + blockSize2);
+}
@@ -0,0 +1,141 @@
+#include "SpectrumComponent.h"
+
+SpectrumComponent::SpectrumComponent(SpectrumAnalyzer& source)
+    : analyzer(source)
+{
+}
+
+SpectrumComponent::~SpectrumComponent()
+{
+    if (attached)
+        analyzer.removeClient();
+}
+
+void SpectrumComponent::visibilityChanged()
+{
+    updateAttachment();
+}
+
+void SpectrumComponent::parentHierarchyChanged()
+{
+    updateAttachment();
+}
+
+void SpectrumComponent::updateAttachment()
+{
+    // Keep the analysis thread running only while there is something to
+    // draw into
+    const bool shouldAttach = isShowing();
+    if (shouldAttach == attached)
+        return;
+
+    attached = shouldAttach;
+    if (attached)
+        analyzer.addClient();
+    else
+        analyzer.removeClient();
+}
+
+void SpectrumComponent::updateFromVBlank()
+{
+    // Catches minimising, which changes isShowing() without a callback
+    updateAttachment();
+    if (! attached)
+        return;
+
+    auto latest = analyzer.getSnapshot();
+    if (latest != shownSnapshot)
+    {
+        shownSnapshot = std::move(latest);
+        repaint();
+    }
+}
+
+void SpectrumComponent::paint(juce::Graphics& g)
+{
+    const auto bounds = getLocalBounds().toFloat();
+    if (bounds.isEmpty())
+        return;
+
+    updateBackground(g.getInternalContext().getPhysicalPixelScaleFactor());
+    g.drawImage(backgroundImage, bounds);
+
+    if (shownSnapshot == nullptr)
+        return;
+
+    g.setColour(juce::Colours::grey.withAlpha(0.7f));
+    g.strokePath(createSpectrumPath(shownSnapshot->inputDb, *shownSnapshot), juce::PathStrokeType(1.0f));
+
+    g.setColour(juce::Colour(0xffD4B870));
+    g.strokePath(createSpectrumPath(shownSnapshot->outputDb, *shownSnapshot), juce::PathStrokeType(1.0f));
+}
+
+void SpectrumComponent::resized()
+{
+    // Sized for the old bounds
+    backgroundImage = {};
+}
+
+void SpectrumComponent::updateBackground(float scale)
+{
+    if (backgroundImage.isValid() && scale == cachedScale)
+        return;
+
+    cachedScale = scale;
+    const auto bounds = getLocalBounds().toFloat();
+    backgroundImage = juce::Image(juce::Image::ARGB,
+                                  juce::jmax(1, juce::roundToInt(bounds.getWidth() * scale)),
+                                  juce::jmax(1, juce::roundToInt(bounds.getHeight() * scale)), true);
+
+    juce::Graphics bg(backgroundImage);
+    bg.addTransform(juce::AffineTransform::scale(scale));
+
+    bg.setColour(juce::Colours::black);
+    bg.fillRoundedRectangle(bounds, 14.0f);
+
+    // Decades of frequency and 24 dB steps of level
+    const auto area = getPlotArea();
+    const SpectrumAnalyzer::Snapshot defaults;
+    bg.setColour(juce::Colours::darkgrey.withAlpha(0.3f));
+
+    for (float frequency : { 100.0f, 1000.0f, 10000.0f })
+    {
+        const float x = area.getX() + area.getWidth() * std::log(frequency / defaults.minFrequency)
+                                                      / std::log(defaults.maxFrequency / defaults.minFrequency);
+        bg.drawVerticalLine(juce::roundToInt(x), area.getY(), area.getBottom());
+    }
+
+    for (float level = 0.0f; level > minDb; level -= 24.0f)
+    {
+        const float y = juce::jmap(level, minDb, maxDb, area.getBottom(), area.getY());
+        bg.drawHorizontalLine(juce::roundToInt(y), area.getX(), area.getRight());
+    }
+}
+
+juce::Path SpectrumComponent::createSpectrumPath(const std::array<float, SpectrumAnalyzer::numBins>& levels,
+                                                 const SpectrumAnalyzer::Snapshot& spectra) const
+{
+    // Bins are log-spaced, so they sit evenly across the width. Below 44.1 kHz
+    // the range stops short of 20 kHz and the curve short of the right edge.
+    const auto area = getPlotArea();
+    const SpectrumAnalyzer::Snapshot defaults;
+    const float width = area.getWidth() * std::log(spectra.maxFrequency / spectra.minFrequency)
+                                        / std::log(defaults.maxFrequency / defaults.minFrequency);
+
+    juce::Path path;
+    path.preallocateSpace(3 * SpectrumAnalyzer::numBins);
+
+    for (int bin = 0; bin < SpectrumAnalyzer::numBins; ++bin)
+    {
+        const float x = area.getX() + width * static_cast<float>(bin) / static_cast<float>(SpectrumAnalyzer::numBins - 1);
+        const float level = juce::jlimit(minDb, maxDb, levels[static_cast<size_t>(bin)]);
+        const float y = juce::jmap(level, minDb, maxDb, area.getBottom(), area.getY());
+
+        if (bin == 0)
+            path.startNewSubPath(x, y);
+        else
+            path.lineTo(x, y);
+    }
+
+    return path;
+}
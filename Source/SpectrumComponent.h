@@ -0,0 +1,46 @@
+#pragma once
+
+#include <juce_gui_basics/juce_gui_basics.h>
+#include "SpectrumAnalyzer.h"
+
+// Input (grey) and output (gold) spectra from the processor's
+// SpectrumAnalyzer, on a log frequency axis. The analyzer only runs while
+// this component is showing, and a repaint is issued only when a new
+// snapshot has been published.
+class SpectrumComponent : public juce::Component
+{
+public:
+    explicit SpectrumComponent(SpectrumAnalyzer& source);
+    ~SpectrumComponent() override;
+
+    void paint(juce::Graphics& g) override;
+    void resized() override;
+    void visibilityChanged() override;
+    void parentHierarchyChanged() override;
+
+private:
+    SpectrumAnalyzer& analyzer;
+    bool attached = false;
+    void updateAttachment();
+
+    std::shared_ptr<const SpectrumAnalyzer::Snapshot> shownSnapshot;
+    void updateFromVBlank();
+
+    // Displayed range
+    static constexpr float minDb = -96.0f;
+    static constexpr float maxDb = 6.0f;
+    juce::Rectangle<float> getPlotArea() const { return getLocalBounds().toFloat().reduced(4.0f); }
+    juce::Path createSpectrumPath(const std::array<float, SpectrumAnalyzer::numBins>& levels,
+                                  const SpectrumAnalyzer::Snapshot& spectra) const;
+
+    // Rounded background with the frequency and level grid, drawn once per
+    // size and display scale
+    juce::Image backgroundImage;
+    float cachedScale = 0.0f;
+    void updateBackground(float scale);
+
+    // Last, so it never fires into a partly constructed component
+    juce::VBlankAttachment vBlankAttachment { this, [this]() { updateFromVBlank(); } };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SpectrumComponent)
+};
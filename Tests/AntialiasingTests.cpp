@@ -0,0 +1,94 @@
+// Antiderivative anti-aliasing on the inputs that stress it most: a slow,
+// full-scale sine at drive 1000. Consecutive inputs are close together while
+// the antiderivatives are huge, so any loss of precision in the divided
+// differences shows up as output far outside the waveshaper's range.
+
+#include <juce_core/juce_core.h>
+#include <algorithm>
+#include <cmath>
+#include <type_traits>
+#include <vector>
+#include "DSP/Waveshapers.h"
+
+namespace
+{
+class AntialiasingTests final : public juce::UnitTest
+{
+public:
+    AntialiasingTests() : juce::UnitTest("Antiderivative anti-aliasing", "DSP") {}
+
+    void runTest() override
+    {
+        beginTest("Tanh stays within +-1 on a slow sine at drive 1000");
+        for (auto mode : { AntialiasingMode::FirstOrder, AntialiasingMode::SecondOrder })
+        {
+            expectWithinRange<TanhWaveshaper<ReferenceMath, float>, float>(mode);
+            expectWithinRange<TanhWaveshaper<ReferenceMath, double>, double>(mode);
+        }
+
+        beginTest("Tube and foldback stay within +-1 on a slow sine at drive 1000");
+        expectWithinRange<TubeWaveshaper<ReferenceMath, float>, float>(AntialiasingMode::SecondOrder);
+        expectWithinRange<FoldbackWaveshaper<ReferenceMath, float>, float>(AntialiasingMode::FirstOrder);
+    }
+
+private:
+    template <typename Shaper, typename SampleType>
+    void expectWithinRange(AntialiasingMode mode)
+    {
+        // Every waveshaper's output is within +-1 for asymmetry up to 0.5
+        // (the asymmetric fold reaches 1.25 * 0.8). Second order divides by
+        // input differences twice, so double keeps a rounding margin far
+        // below anything audible; in float it rounds away.
+        const double margin = std::is_same_v<SampleType, float> ? 0.0 : 1.0e-7;
+        const auto limit = static_cast<SampleType>(1.0 + margin);
+
+        for (double frequency : { 0.5, 2.0, 20.0 })
+        {
+            for (float asymmetry : { 0.0f, 0.5f })
+            {
+                WaveshaperParameters parameters;
+                parameters.drive = 1000.0f;
+                parameters.asymmetry = asymmetry;
+                const Shaper shaper(parameters);
+
+                // Two seconds at 48 kHz in 512-sample blocks, so the history
+                // carried between blocks is exercised too
+                constexpr int numSamples = 96000;
+                constexpr int blockSize = 512;
+                std::vector<SampleType> samples(static_cast<size_t>(numSamples));
+                for (int i = 0; i < numSamples; ++i)
+                    samples[static_cast<size_t>(i)] = static_cast<SampleType>(
+                            std::sin(juce::MathConstants<double>::twoPi * frequency * i / 48000.0));
+
+                AntialiasingState state;
+                for (int offset = 0; offset < numSamples; offset += blockSize)
+                {
+                    const int blockLength = std::min(blockSize, numSamples - offset);
+                    if constexpr (Shaper::antialiasingOrder >= 2)
+                    {
+                        if (mode == AntialiasingMode::SecondOrder)
+                        {
+                            ADAA::processSecondOrder(shaper, state, samples.data() + offset, blockLength);
+                            continue;
+                        }
+                    }
+
+                    ADAA::processFirstOrder(shaper, state, samples.data() + offset, blockLength);
+                }
+
+                SampleType peak = 0;
+                for (auto sample : samples)
+                    peak = std::max(peak, std::abs(sample));
+
+                expect(peak <= limit,
+                       "Peak " + juce::String(static_cast<double>(peak), 12) + " exceeds "
+                       + juce::String(static_cast<double>(limit), 12) + " at " + juce::String(frequency)
+                       + " Hz, asymmetry " + juce::String(asymmetry)
+                       + (mode == AntialiasingMode::SecondOrder ? ", second order" : ", first order"));
+            }
+        }
+    }
+};
+
+AntialiasingTests antialiasingTests;
+} // namespace
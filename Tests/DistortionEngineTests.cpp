@@ -0,0 +1,80 @@
+// DistortionEngine behaviour that only shows over many blocks, such as how
+// it settles once the input stops.
+
+#include <juce_core/juce_core.h>
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include "DSP/DistortionEngine.h"
+
+namespace
+{
+class DistortionEngineTests final : public juce::UnitTest
+{
+public:
+    DistortionEngineTests() : juce::UnitTest("Distortion engine", "DSP") {}
+
+    void runTest() override
+    {
+        beginTest("Goes idle within its reported tail once the input stops");
+        for (float subOctave : { 0.0f, 1.0f })
+            for (float asymmetry : { 0.0f, 0.7f })
+                expectSettles(subOctave, asymmetry);
+    }
+
+private:
+    void expectSettles(float subOctave, float asymmetry)
+    {
+        constexpr double sampleRate = 48000.0;
+        constexpr int blockSize = 512;
+
+        DistortionEngine<float> engine;
+        engine.prepare(sampleRate, blockSize, 2);
+
+        DistortionParameters parameters;
+        parameters.drive = 10.0f;
+        parameters.asymmetry = asymmetry;
+        parameters.subOctave = subOctave;
+        engine.setParameters(parameters);
+
+        std::vector<float> left(blockSize), right(blockSize);
+        float* channels[] = { left.data(), right.data() };
+
+        // One second of a 110 Hz sine, so the octave divider is running
+        for (int block = 0; block < 94; ++block)
+        {
+            for (int i = 0; i < blockSize; ++i)
+                left[static_cast<size_t>(i)] = right[static_cast<size_t>(i)] = 0.5f * static_cast<float>(
+                        std::sin(juce::MathConstants<double>::twoPi * 110.0 * (block * blockSize + i) / sampleRate));
+
+            engine.process(channels, 2, blockSize);
+        }
+
+        // The state is checked once per block, so allow one block on top
+        const int tailBlocks = static_cast<int>(std::ceil(engine.getTailLengthSeconds() * sampleRate / blockSize)) + 1;
+        float peak = 0.0f;
+        for (int block = 0; block <= tailBlocks; ++block)
+        {
+            std::fill(left.begin(), left.end(), 0.0f);
+            std::fill(right.begin(), right.end(), 0.0f);
+            engine.process(channels, 2, blockSize);
+
+            for (auto sample : left)
+                peak = std::max(peak, std::abs(sample));
+        }
+
+        const auto description = "sub-octave " + juce::String(subOctave) + ", asymmetry " + juce::String(asymmetry);
+        expect(engine.getProcessingState() == DistortionEngine<float>::ProcessingState::Idle,
+               "Still processing after the tail, " + description);
+        expect(peak > 0.0f, "No tail at all, " + description);
+
+        // Once idle, the output is silence rather than whatever the filters held
+        engine.process(channels, 2, blockSize);
+        expect(*std::max_element(left.begin(), left.end()) == 0.0f
+                   && *std::min_element(left.begin(), left.end()) == 0.0f,
+               "Idle output is not silent, " + description);
+    }
+};
+
+DistortionEngineTests distortionEngineTests;
+} // namespace
@@ -0,0 +1,25 @@
+// Runs every juce::UnitTest linked into ObliteratorTests and exits non-zero
+// if any expectation failed, so ctest reports it.
+//
+//   ObliteratorTests [--seed=n]
+
+#include <juce_core/juce_core.h>
+
+int main(int argc, char* argv[])
+{
+    juce::ArgumentList arguments(argc, argv);
+
+    juce::UnitTestRunner runner;
+    runner.setAssertOnFailure(false);
+
+    if (arguments.containsOption("--seed"))
+        runner.runAllTests(arguments.getValueForOption("--seed").getLargeIntValue());
+    else
+        runner.runAllTests();
+
+    for (int i = 0; i < runner.getNumResults(); ++i)
+        if (runner.getResult(i)->failures > 0)
+            return 1;
+
+    return 0;
+}